@@ -4,6 +4,9 @@
 #include "daScript/misc/performance_time.h"
 #include "daScript/misc/fpe.h"
 #include "daScript/misc/sysos.h"
+#include "daScript/ast/ast_aot_live.h"
+#include "daScript/simulate/baseline_jit.h"
+#include "daScript/simulate/aot_builtin_jit.h"
 
 #ifdef _MSC_VER
 #include <io.h>
@@ -21,6 +24,7 @@ bool g_useSerialization = false;
 bool g_reportCompilationFailErrors = false;
 bool g_collectSharedModules = true;
 bool g_failOnSmartPtrLeaks = true;
+bool g_useBaselineJit = false;
 
 TextPrinter tout;
 
@@ -162,6 +166,9 @@ bool unit_test ( const string & fn, bool useAot, bool useSer ) {
                     }
                     return false;
                 }
+                if ( g_useBaselineJit ) {
+                    das_baseline_jit_context(ctx, false, &ctx, nullptr);
+                }
                 if ( auto fnTest = ctx.findFunction("test") ) {
                     if ( !verifyCall<bool>(fnTest->debugInfo, dummyLibGroup) ) {
                         tout << "function 'test', call arguments do not match\n";
@@ -178,7 +185,7 @@ bool unit_test ( const string & fn, bool useAot, bool useSer ) {
                         return false;
                     }
                     int usec = get_time_usec(timeStamp);
-                    tout << (useAot ? "ok AOT " : "ok ") << ((usec/1000)/1000.0) << "\n";
+                    tout << (useAot ? "ok AOT " : (g_useBaselineJit ? "ok BASELINE JIT " : "ok ")) << ((usec/1000)/1000.0) << "\n";
                     return true;
                 } else {
                     tout << "function 'test' not found\n";
@@ -317,6 +324,15 @@ bool run_unit_tests( const string & path, bool check_aot = false, bool useSer =
     }
 }
 
+// same unit tests, with every function the baseline jit can compile installed as native code
+bool run_baseline_jit_unit_tests( const string & path ) {
+    if ( !baselineJitAvailable() ) return true;
+    g_useBaselineJit = true;
+    bool ok = run_tests(path, unit_test, false);
+    g_useBaselineJit = false;
+    return ok;
+}
+
 bool isolated_unit_test ( const string & fn, bool useAot, bool useSer ) {
     // register modules
     g_collectSharedModules = false;
@@ -421,6 +437,58 @@ bool run_module_test ( const string & path, const string & main, bool usePak, bo
     }
 }
 
+bool run_live_aot_test ( const string & fn ) {
+    tout << "testing LIVE AOT " << fn << " ";
+    auto fAccess = make_smart<FsFileAccess>();
+    ModuleGroup dummyLibGroup;
+    auto program = compileDaScript(fn, fAccess, tout, dummyLibGroup);
+    if ( !program || program->failed() ) {
+        tout << "failed to compile\n";
+        return false;
+    }
+    LiveAotOptions options;
+    options.background = false;
+    string soPath, cppPath;
+    {
+        Context ctx(program->getContextStackSize());
+        if ( !program->simulate(ctx, tout) ) {
+            tout << "failed to simulate\n";
+            return false;
+        }
+        LiveAot live(options);
+        TextWriter logs;
+        if ( !live.start(program, ctx, logs) ) {
+            // no system compiler, or host does not export runtime symbols
+            tout << "failed to build the library\n" << logs.str();
+            return false;
+        }
+        soPath = live.libraryPath();
+    }
+    bool ok = false;
+    {
+        // second run must link from the cache, without the compiler
+        Context ctx(program->getContextStackSize());
+        program->simulate(ctx, tout);
+        LiveAot live(options);
+        TextWriter logs;
+        if ( !live.start(program, ctx, logs) || live.libraryPath()!=soPath ) {
+            tout << "failed to link from the cache\n" << logs.str();
+        } else if ( auto fnTest = ctx.findFunction("test") ) {
+            ctx.restart();
+            ok = cast<bool>::to(ctx.evalWithCatch(fnTest, nullptr)) && !ctx.getException();
+            tout << (ok ? "ok\n" : "failed\n");
+        } else {
+            tout << "function 'test' not found\n";
+        }
+    }
+    auto base = soPath.substr(0, soPath.rfind('.'));
+    remove((base + ".cpp").c_str());
+    remove((base + ".log").c_str());
+    // library stays loaded on windows, so it may not be removed
+    remove(soPath.c_str());
+    return ok;
+}
+
 int main( int argc, char * argv[] ) {
     if ( argc>2 ) {
         tout << "daScriptTest [pathToDasRoot]\n";
@@ -545,6 +613,7 @@ int main( int argc, char * argv[] ) {
     ok = run_compilation_fail_tests(getDasRoot() + "/examples/test/compilation_fail_tests") && ok;
     ok = run_unit_tests(getDasRoot() +  "/examples/test/unit_tests",    true,  g_useSerialization) && ok;
     ok = run_unit_tests(getDasRoot() +  "/examples/test/optimizations", false, g_useSerialization) && ok;
+    ok = run_baseline_jit_unit_tests(getDasRoot() +  "/examples/test/unit_tests") && ok;
     ok = run_exception_tests(getDasRoot() +  "/examples/test/runtime_errors") && ok;
     ok = run_module_test(getDasRoot() +  "/examples/test/module", "main.das",        true, g_useSerialization) && ok;
     ok = run_module_test(getDasRoot() +  "/examples/test/module", "main_inc.das",    true, g_useSerialization)  && ok;
@@ -552,6 +621,7 @@ int main( int argc, char * argv[] ) {
     ok = run_module_test(getDasRoot() +  "/examples/test/module/alias",  "main.das", true, g_useSerialization) && ok;
     ok = run_module_test(getDasRoot() +  "/examples/test/module/cdp",    "main.das", true, g_useSerialization) && ok;
     ok = run_module_test(getDasRoot() +  "/examples/test/module/unsafe", "main.das", true, g_useSerialization) && ok;
+    ok = run_live_aot_test(getDasRoot() +  "/examples/test/unit_tests/access_private_from_lambda.das") && ok;
     int usec = get_time_usec(timeStamp);
     tout << "TESTS " << (ok ? "PASSED " : "FAILED!!! ") << ((usec/1000)/1000.0) << "\n";
     // shutdown
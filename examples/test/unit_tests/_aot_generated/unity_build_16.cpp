@@ -0,0 +1,11 @@
+// unity build batch 16
+#include "test_move_on_return.das.cpp"
+#include "test_template.das.cpp"
+#include "test_value_table_key.das.cpp"
+#include "time.das.cpp"
+#include "toarray.das.cpp"
+#include "totable.das.cpp"
+#include "trailing_delimiters.das.cpp"
+#include "try-catch.das.cpp"
+#include "tuple.das.cpp"
+#include "typeAlias.das.cpp"
@@ -0,0 +1,11 @@
+// unity build batch 17
+#include "typeinfo.das.cpp"
+#include "typename.das.cpp"
+#include "types.das.cpp"
+#include "unused_arguments.das.cpp"
+#include "utf8.das.cpp"
+#include "variant.das.cpp"
+#include "variant_align.das.cpp"
+#include "vec_ctors.das.cpp"
+#include "vec_index.das.cpp"
+#include "vec_swizzle.das.cpp"
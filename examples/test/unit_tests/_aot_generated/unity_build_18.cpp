@@ -0,0 +1,2 @@
+// unity build batch 18
+#include "with.das.cpp"
@@ -0,0 +1,117 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "daScript/daScriptC.h"
+
+const char * TUTORIAL_SOURCE_CODE =
+"[export]\n"
+"def add ( a, b : int )\n"
+"    return a + b\n"
+;
+
+#define TOTAL_CALLS 10000000
+
+static double elapsed_sec ( clock_t t0 ) {
+    return (double)(clock() - t0) / CLOCKS_PER_SEC;
+}
+
+void tutorial () {
+    das_text_writer * tout = das_text_make_printer();
+    das_module_group * dummyLibGroup = das_modulegroup_make();
+    das_file_access * fAccess = das_fileaccess_make_default();
+    das_context * ctx = NULL;
+    das_prepared_call * call = NULL;
+    vec4f * args = NULL;
+    vec4f * results = NULL;
+    // compile and simulate program
+    das_fileaccess_introduce_file(fAccess, "tutorial.das", TUTORIAL_SOURCE_CODE);
+    das_program * program = das_program_compile("tutorial.das", fAccess, tout, dummyLibGroup);
+    if ( das_program_err_count(program) ) {
+        das_text_output(tout, "failed to compile\n");
+        goto shutdown;
+    }
+    ctx = das_context_make(das_program_context_stack_size(program));
+    if ( !das_program_simulate(program,ctx,tout) ) {
+        das_text_output(tout, "failed to simulate\n");
+        goto shutdown;
+    }
+    das_function * fnAdd = das_context_find_function(ctx,"add");
+    if ( !fnAdd ) {
+        das_text_output(tout, "function 'add' not found\n");
+        goto shutdown;
+    }
+    // one call at a time, catch frame is set up for every call
+    {
+        vec4f cargs[2];
+        long long sum = 0;
+        clock_t t0 = clock();
+        for ( int i=0; i!=TOTAL_CALLS; ++i ) {
+            cargs[0] = das_result_int(i);
+            cargs[1] = das_result_int(1);
+            sum += das_argument_int(das_context_eval_with_catch(ctx, fnAdd, cargs));
+        }
+        printf("das_context_eval_with_catch  %i calls in %.3f sec, sum=%lld\n", TOTAL_CALLS, elapsed_sec(t0), sum);
+    }
+    // all calls in one batch, arguments are laid out with the stride of 2
+    args = (vec4f *) malloc(sizeof(vec4f) * 2 * TOTAL_CALLS);
+    results = (vec4f *) malloc(sizeof(vec4f) * TOTAL_CALLS);
+    for ( int i=0; i!=TOTAL_CALLS; ++i ) {
+        args[i*2+0] = das_result_int(i);
+        args[i*2+1] = das_result_int(1);
+    }
+    {
+        long long sum = 0;
+        clock_t t0 = clock();
+        int done = das_context_eval_batch(ctx, fnAdd, args, 2, TOTAL_CALLS, results);
+        for ( int i=0; i!=done; ++i ) sum += das_argument_int(results[i]);
+        printf("das_context_eval_batch       %i calls in %.3f sec, sum=%lld\n", done, elapsed_sec(t0), sum);
+    }
+    // prepared call, argument layout is cached in the handle
+    call = das_context_prepare_call(ctx, fnAdd, 2);
+    if ( !call ) {
+        das_text_output(tout, "can't prepare call to 'add'\n");
+        goto shutdown;
+    }
+    {
+        vec4f * cargs = das_prepared_call_arguments(call);
+        long long sum = 0;
+        clock_t t0 = clock();
+        for ( int i=0; i!=TOTAL_CALLS; ++i ) {
+            cargs[0] = das_result_int(i);
+            cargs[1] = das_result_int(1);
+            sum += das_argument_int(das_prepared_call_eval(call));
+        }
+        printf("das_prepared_call_eval       %i calls in %.3f sec, sum=%lld\n", TOTAL_CALLS, elapsed_sec(t0), sum);
+    }
+    {
+        long long sum = 0;
+        clock_t t0 = clock();
+        int done = das_prepared_call_eval_batch(call, args, TOTAL_CALLS, results);
+        for ( int i=0; i!=done; ++i ) sum += das_argument_int(results[i]);
+        printf("das_prepared_call_eval_batch %i calls in %.3f sec, sum=%lld\n", done, elapsed_sec(t0), sum);
+    }
+    char * ex = das_context_get_exception(ctx);
+    if ( ex!=NULL ) {
+        das_text_output(tout, "exception: ");
+        das_text_output(tout, ex);
+        das_text_output(tout, "\n");
+    }
+shutdown:;
+    free(args);
+    free(results);
+    das_prepared_call_release(call);
+    das_context_release(ctx);
+    das_program_release(program);
+    das_fileaccess_release(fAccess);
+    das_modulegroup_release(dummyLibGroup);
+    das_text_release(tout);
+}
+
+int main( int argc, char ** argv ) {
+    (void)argc; (void)argv;
+    das_initialize();
+    tutorial();
+    das_shutdown();
+    return 0;
+}
@@ -196,6 +196,9 @@ namespace das
         void* operator new ( size_t count ) { return das_aligned_alloc16(count); }
         void operator delete  ( void* ptr ) { auto size = das_aligned_memsize(ptr);
             memset(ptr, 0xcd, size); das_aligned_free16(ptr); }
+#elif DAS_AST_ARENA
+    public:
+        DAS_NODE_ARENA_NEW_DELETE
 #endif
     };
 
@@ -307,6 +310,9 @@ namespace das
         void* operator new ( size_t count ) { return das_aligned_alloc16(count); }
         void operator delete  ( void* ptr ) { auto size = das_aligned_memsize(ptr);
             memset(ptr, 0xcd, size); das_aligned_free16(ptr); }
+#elif DAS_AST_ARENA
+    public:
+        DAS_NODE_ARENA_NEW_DELETE
 #endif
     };
 
@@ -369,6 +375,9 @@ namespace das
         void* operator new ( size_t count ) { return das_aligned_alloc16(count); }
         void operator delete  ( void* ptr ) { auto size = das_aligned_memsize(ptr);
             memset(ptr, 0xcd, size); das_aligned_free16(ptr); }
+#elif DAS_AST_ARENA
+    public:
+        DAS_NODE_ARENA_NEW_DELETE
 #endif
     };
 
@@ -681,6 +690,9 @@ namespace das
         void* operator new ( size_t count ) { return das_aligned_alloc16(count); }
         void operator delete  ( void* ptr ) { auto size = das_aligned_memsize(ptr);
             memset(ptr, 0xcd, size); das_aligned_free16(ptr); }
+#elif DAS_AST_ARENA
+    public:
+        DAS_NODE_ARENA_NEW_DELETE
 #endif
     };
 
@@ -933,6 +945,9 @@ namespace das
         void* operator new ( size_t count ) { return das_aligned_alloc16(count); }
         void operator delete  ( void* ptr ) { auto size = das_aligned_memsize(ptr);
             memset(ptr, 0xcd, size); das_aligned_free16(ptr); }
+#elif DAS_AST_ARENA
+    public:
+        DAS_NODE_ARENA_NEW_DELETE
 #endif
     };
 
@@ -1089,6 +1104,10 @@ namespace das
         static TypeAnnotation * resolveAnnotation ( const TypeInfo * info );
         static Type findOption ( const string & name );
         static void foreach(const callable<bool(Module * module)> & func);
+        static uint32_t functionGeneration ( uint64_t nameHash );   // changes every time function or generic with this name is added or removed
+        static void touchFunctionGeneration ( uint64_t nameHash );
+        static uint32_t requireGeneration ();                       // changes every time any module's require list changes
+        static void touchRequireGeneration ();
         virtual uintptr_t rtti_getUserData() {return uintptr_t(0);}
         void verifyAotReady();
         void verifyBuiltinNames(uint32_t flags);
@@ -1351,6 +1370,32 @@ namespace das
         das_map<string,VarInfo *>           vmn2v;
         das_map<string,FuncInfo *>          fmn2f;
         das_map<string,EnumInfo *>          emn2e;
+        das_hash_map<uint64_t,TypeInfo *>   th2t;       // same as tmn2t, but keyed by the mangled name hash
+        uint64_t                            typeLookups = 0;
+    };
+
+    // Debug info helper which outlives simulate. Instead of collecting local and global variables of every function
+    // and block upfront, remembers where they come from, and appends them on the first request (stack walk, GC, debugger).
+    // It does not keep the program alive. Whatever is still pending when the program goes away is dropped,
+    // and these functions and blocks have no local and global variables in the debug info.
+    class LazyDebugInfoHelper : public DebugInfoHelper, public LazyDebugInfo {
+    public:
+        LazyDebugInfoHelper ( const shared_ptr<DebugInfoAllocator> & di );
+        void defer ( FuncInfo * info, const ExpressionPtr & body, const FunctionPtr & func );
+        virtual void materialize ( FuncInfo * info ) override;
+        virtual void logMemInfo ( TextWriter & tw ) override;
+        void abandon();
+        size_t deferred() const { return totalPending.load(std::memory_order_acquire); }
+    protected:
+        das_hash_map<FuncInfo *,pair<ExpressionPtr,FunctionPtr>>    pending;
+        std::atomic<size_t>                                         totalPending { 0 };
+        mutex                                                       lock;
+        // under the lock
+        uint64_t    totalDeferred = 0;
+        uint64_t    totalMaterialized = 0;
+        uint64_t    totalAbandoned = 0;
+        uint64_t    materializedBytes = 0;
+        int64_t     materializeNsec = 0;
     };
 
     struct CodeOfPolicies {
@@ -1360,6 +1405,7 @@ namespace das
         bool        completion = false;                 // this code is being compiled for 'completion' mode
         bool        export_all = false;                 // when user compiles, export all (public?) functions
         bool        serialize_main_module = true;       // if false, then we recompile main module each time
+        bool        ast_arena = false;                  // allocate AST nodes of each program from its own arena (only with DAS_AST_ARENA)
     // error reporting
         int32_t     always_report_candidates_threshold = 6; // always report candidates if there are less than this number
     // memory
@@ -1470,9 +1516,47 @@ namespace das
         virtual void afterAlias ( const char * name, const LineInfo & at ) = 0;
     };
 
+    // what infer macro looked at during its last run, see Program::inferTypes
+    // what infer macro was handed during its last run, i.e. visited or looked up. macro can only change in place what it was handed
+    struct MacroInputs {
+        das_hash_set<void *>    objects;                    // functions, structures, and global variables of this module
+        bool                    visitedProgram = false;     // if macro never visited the program, we don't know what it depends on
+        void clear() { objects.clear(); visitedProgram = false; }
+    };
+
+    struct PassMacroTiming {
+        int64_t     macroTicks = 0;     // in apply
+        int64_t     inferTicks = 0;     // in inferTypesDirty after apply did work
+        uint32_t    runs = 0;
+        uint32_t    works = 0;
+        uint32_t    skipped = 0;        // reruns, which were avoided because nothing macro looked at has changed
+    };
+
+    // overload resolution key, i.e. name and argument type hashes along with the visibility (see InferTypes::getOverloadCacheKey)
+    struct OverloadCacheKey {
+        enum { maxWords = 6 + DAS_MAX_FUNCTION_ARGUMENTS };
+        uint64_t    words[maxWords];
+        uint32_t    size = 0;
+        uint64_t    hash = 0;
+        void clear() { size = 0; }
+        void push_back ( uint64_t w ) { DAS_ASSERT(size<maxWords); words[size++] = w; }
+        const uint64_t * begin() const { return words; }
+        const uint64_t * end() const { return words + size; }
+        bool operator != ( const OverloadCacheKey & k ) const { return size!=k.size || memcmp(words, k.words, size*sizeof(uint64_t))!=0; }
+    };
+
+    // cached result of the overload resolution, valid while function generation of the name does not change.
+    // cache is keyed by the hash of the key, and the entry keeps the key, so there are no false hits
+    struct OverloadCacheEntry {
+        OverloadCacheKey    key;
+        vector<Function *>  functions;
+        uint32_t            generation = 0;
+    };
+
     class Program : public ptr_ref_count {
     public:
         Program();
+        virtual ~Program();
         int getContextStackSize() const;
         friend StringWriter& operator<< (StringWriter& stream, const Program & program);
         vector<StructurePtr> findStructure ( const string & name ) const;
@@ -1496,6 +1580,11 @@ namespace das
         void inferTypes(TextWriter & logs, ModuleGroup & libGroup);
         void inferTypesDirty(TextWriter & logs, bool verbose);
         bool relocatePotentiallyUninitialized(TextWriter & logs);
+        void markMacroDirty ( void * obj );
+        uint64_t getMacroShapeStamp() const;
+        void touchMacroInput ( Module * mod, void * obj ) {
+            if ( macroInputs && mod==thisModule.get() ) macroInputs->objects.insert(obj);   // macro may edit what it found in place
+        }
         void lint (TextWriter & logs, ModuleGroup & libGroup );
         void checkSideEffects();
         void foldUnsafe();
@@ -1600,6 +1689,17 @@ namespace das
         CodeOfPolicies              policies;
         vector<tuple<Module *,string,string,bool,LineInfo>> allRequireDecl;
         das_hash_map<uint64_t,TypeDecl *> astTypeInfo;
+        NodeArena *                 nodeArena = nullptr;
+        vector<eastl::weak_ptr<LazyDebugInfoHelper>> lazyDebugInfo;  // of every context simulated with lazy_debug_info
+        das_hash_map<uint64_t,OverloadCacheEntry> overloadCache;
+        uint64_t                    overloadCacheHits = 0;
+        uint64_t                    overloadCacheMisses = 0;
+        MacroInputs *               macroInputs = nullptr;      // when set, visitModule records what was visited
+        das_hash_set<void *>        macroDirty;                 // what inference changed after infer macro did work
+        bool                        macroDirtyAll = false;      // something without owner changed, i.e. all macros are dirty
+        bool                        trackMacroDirty = false;
+        das_hash_map<void *,uint64_t> macroStamps;              // node stamps of functions, globals, and structures, as of the last infer pass
+        bool                        collectMacroStamps = false;
     };
 
     // module parsing routines
@@ -1672,6 +1772,7 @@ namespace das
         bool            g_resolve_annotations = true;
         TextWriter *    g_compilerLog = nullptr;
         int64_t         macroTimeTicks = 0;
+        das_map<string,PassMacroTiming> passMacroTimes;
         AstSerializer * serializer_read = nullptr;
         AstSerializer * serializer_write = nullptr;
         DebugAgentInstance g_threadLocalDebugAgent;
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "daScript/ast/ast.h"
+#include "daScript/simulate/aot_library.h"
+
+#include <thread>
+#include <atomic>
+#include <memory>
+
+namespace das {
+
+    struct LiveAotOptions {
+        string  cacheDir;                                       // generated .cpp, compiled library and compiler log go here
+        string  compiler = "c++ -O2 -shared -fPIC";
+        string  flags;                                          // empty means configuration of this build, and include paths of the das root
+        bool    background = true;                              // otherwise start() waits for the compiler
+    };
+
+    // Load time AOT. Generates the same C++ as 'daScript -aot', builds it with the system compiler into a shared library,
+    // and links the library into the live context. Libraries are cached on disk by the semantic hash of the program
+    // and the build of the runtime, so only the first run pays for the compilation. The host executable must export
+    // its symbols (-rdynamic), and the library is never unloaded, since AOT nodes live in it.
+    class LiveAot {
+    public:
+        LiveAot ( const LiveAotOptions & opt );
+        ~LiveAot();                                             // does not wait, the compiler finishes the cache on its own
+        // links cached library immediately, otherwise starts the compiler. returns true if linked
+        bool start ( const ProgramPtr & program, Context & context, TextWriter & logs );
+        // links the library once background compilation is done. call only when the context is not running
+        bool poll ( Context & context, TextWriter & logs );
+        bool pending() const { return *state==compiling; }
+        bool linked() const { return *state==done; }
+        const string & libraryPath() const { return soPath; }
+    protected:
+        bool generate ( const ProgramPtr & program, Context & context, TextWriter & cpp, TextWriter & logs );
+        string compileCommand() const;
+        bool load ( Context & context, TextWriter & logs );
+    protected:
+        enum State : int32_t { idle, compiling, compiled, failed, done };
+        LiveAotOptions          options;
+        vector<uint64_t>        functionHashes;                 // by SimFunction index, 0 if not AOT
+        string                  cppPath;
+        string                  soPath;
+        string                  logPath;
+        std::thread             worker;                         // only touches the state, so that it can outlive us
+        std::shared_ptr<std::atomic<int32_t>> state;
+        AotLibrary              aotLib;
+    };
+}
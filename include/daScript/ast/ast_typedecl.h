@@ -262,6 +262,9 @@ namespace das {
         void* operator new ( size_t count ) { return das_aligned_alloc16(count); }
         void operator delete  ( void* ptr ) { auto size = das_aligned_memsize(ptr);
             memset(ptr, 0xcd, size); das_aligned_free16(ptr); }
+#elif DAS_AST_ARENA
+    public:
+        DAS_NODE_ARENA_NEW_DELETE
 #endif
     };
 
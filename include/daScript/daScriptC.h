@@ -58,6 +58,7 @@ typedef struct dasModule das_module;
 typedef struct dasNode das_node;
 typedef struct dasStructure das_structure;
 typedef struct dasEnumeration das_enumeration;
+typedef struct dasPreparedCall das_prepared_call;
 
 typedef vec4f (das_interop_function) ( das_context * ctx, das_node * node, vec4f * arguments );
 
@@ -95,6 +96,17 @@ void das_context_release ( das_context * context );
 das_function * das_context_find_function ( das_context * context, char * name );
 vec4f das_context_eval_with_catch ( das_context * context, das_function * fun, vec4f * arguments );
 char * das_context_get_exception ( das_context * context );
+// evaluates fun count times under a single catch frame. arguments of call i start at arguments + i*args_stride (in vec4f)
+// results can be NULL. returns number of completed calls, which is less than count if exception occurred
+// returns -1 if fun is NULL, or returns its value via cmres (structures, tuples, etc), see das_context_get_exception
+int das_context_eval_batch ( das_context * context, das_function * fun, vec4f * arguments, int args_stride, int count, vec4f * results );
+
+// prepared call caches function and argument layout. returns NULL if function does not take nargs arguments
+das_prepared_call * das_context_prepare_call ( das_context * context, das_function * fun, int nargs );
+void das_prepared_call_release ( das_prepared_call * call );
+vec4f * das_prepared_call_arguments ( das_prepared_call * call );
+vec4f das_prepared_call_eval ( das_prepared_call * call );
+int das_prepared_call_eval_batch ( das_prepared_call * call, vec4f * arguments, int count, vec4f * results );
 
 das_structure * das_structure_make ( das_module_group * lib, const char * name, const char * cppname, int sz, int al );
 void das_structure_add_field ( das_structure * st, das_module * mod, das_module_group * lib,  const char * name, const char * cppname, int offset, const char * tname );
@@ -23,6 +23,8 @@ namespace das {
         Realtime = High,
     };
 
+    class JobWakeList;
+
     class JobStatus {
     public:
         enum { STATUS_MAGIC = 0xdeadbeef };
@@ -35,7 +37,7 @@ namespace das {
         JobStatus & operator = ( const JobStatus & ) = delete;
         void Notify();
         void NotifyAndRelease();
-        bool isReady();
+        bool isReady() const;
         void Wait();
         void Clear(uint32_t count = 1);
         int addRef() { return mRef++; }
@@ -43,12 +45,39 @@ namespace das {
         int size() const;
         int append(int size);
         bool isValid() const { return mMagic==STATUS_MAGIC; }
+        // token is pushed to the list once the wait is over (see isWaitOver), or right away if it's over already.
+        // waiter, which is no longer interested, must be removed before the list goes away
+        void addWaiter ( JobWakeList * list, int32_t token );
+        void removeWaiter ( JobWakeList * list, int32_t token );
+    protected:
+        virtual bool isWaitOver() const { return mRemaining==0; }  // under mCompleteMutex
+        void wakeWaiters();                                         // under mCompleteMutex
     protected:
         mutable mutex		mCompleteMutex;
         uint32_t			mRemaining = 0;
         condition_variable	mCond;
         atomic<int>         mRef{0};
         int32_t             mMagic = STATUS_MAGIC;
+        vector<pair<JobWakeList *,int32_t>> mWaiters;
+    };
+
+    // tokens of the waits which are over. it's never locked along with the status it waits for,
+    // so the waiter can wait again from the drain callback
+    class JobWakeList : public JobStatus {
+    public:
+        void wake ( int32_t token );
+        template <typename TT>
+        void drain ( TT && tt ) {
+            vector<int32_t> woken;
+            {
+                lock_guard<mutex> guard(mCompleteMutex);
+                swap(woken, mWoken);
+            }
+            for ( auto token : woken ) tt(token);
+        }
+        bool isEmpty() const;
+    protected:
+        vector<int32_t> mWoken;
     };
 
     class JobQue {
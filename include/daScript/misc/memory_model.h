@@ -136,13 +136,29 @@ namespace das {
             for ( int i=0; i!= DAS_MAX_SHOE_CUNKS; ++i ) {
                 if ( chunks[i] ) delete chunks[i];
                 chunks[i] = nullptr;
+                decks[i] = 0;
             }
+            lastChunk = nullptr;
+            totalDecks = 0;
+            bytesInUse = 0;
+            bytesReserved = 0;
         }
         void reset() {
             // TODO: modify watermarks
             for ( int i=0; i!= DAS_MAX_SHOE_CUNKS; ++i ) {
                 if ( chunks[i] ) chunks[i]->reset();
             }
+            bytesInUse = 0;
+        }
+        Deck * addDeck ( uint32_t total, uint32_t size ) {
+            DAS_ASSERT(size && size<=DAS_MAX_SHOE_ALLOCATION && (size & 15)==0);
+            uint32_t si = (size >> 4) - 1;
+            auto deck = new Deck(total, size, chunks[si]);
+            chunks[si] = deck;
+            decks[si] ++;
+            totalDecks ++;
+            bytesReserved += uint64_t(deck->total) * uint64_t(deck->size) + (uint64_t(deck->total)/32*4);
+            return deck;
         }
         char * allocate ( uint32_t size ) {
             size = (size + 15) & ~15;
@@ -150,6 +166,7 @@ namespace das {
             uint32_t si = (size >> 4) - 1;
             for ( auto ch = chunks[si]; ch; ch=ch->next ) {
                 if ( char * res = ch->allocate() ) {
+                    bytesInUse += size;
                     return res;
                 }
             }
@@ -162,6 +179,7 @@ namespace das {
             for ( auto ch = chunks[si]; ch; ch=ch->next ) {
                 if ( ch->isOwnPtr(ptr) ) {
                     ch->free(ptr);
+                    bytesInUse -= size;
                     return;
                 }
             }
@@ -215,44 +233,30 @@ namespace das {
             }
             return false;
         }
+        // all stats are maintained as running counters, so this does not walk the decks
         void getStats ( uint32_t & depth, uint32_t & pages, uint64_t & bytes, uint64_t & totalBytes ) const {
             depth = 0;
-            bytes = 0;
-            totalBytes = 0;
-            pages = 0;
             for ( uint32_t si=0; si!= DAS_MAX_SHOE_CUNKS; ++si ) {
-                uint32_t d = 0;
-                for ( auto ch = chunks[si]; ch; ch=ch->next ) {
-                    d ++;
-                    pages ++;
-                    bytes += uint64_t(ch->allocated) * uint64_t(ch->size);
-                    totalBytes += uint64_t(ch->total) * uint64_t(ch->size) + (uint64_t(ch->total)/32*4);
-                }
-                depth = das::max(depth, d);
+                depth = das::max(depth, decks[si]);
             }
+            pages = totalDecks;
+            bytes = bytesInUse;
+            totalBytes = bytesReserved;
         }
         uint32_t depth ( ) const {
             uint32_t d, p; uint64_t b, t;
             getStats(d, p, b, t);
             return d;
         }
-        uint32_t totalChunks ( ) const {
-            uint32_t d, p; uint64_t b, t;
-            getStats(d, p, b, t);
-            return p;
-        }
-        uint64_t bytesAllocated ( ) const {
-            uint32_t d, p; uint64_t b, t;
-            getStats(d, p, b, t);
-            return b;
-        }
-        uint64_t totalBytesAllocated ( ) const {
-            uint32_t d, p; uint64_t b, t;
-            getStats(d, p, b, t);
-            return t;
-        }
+        uint32_t totalChunks ( ) const { return totalDecks; }
+        uint64_t bytesAllocated ( ) const { return bytesInUse; }
+        uint64_t totalBytesAllocated ( ) const { return bytesReserved; }
         Deck *  chunks[DAS_MAX_SHOE_CUNKS];
         mutable Deck *  lastChunk;
+        uint32_t        decks[DAS_MAX_SHOE_CUNKS] = {};
+        uint32_t        totalDecks = 0;
+        uint64_t        bytesInUse = 0;     // recomputed after GC sweep
+        uint64_t        bytesReserved = 0;
     };
 
     typedef function<int(int)> CustomGrowFunction;
@@ -293,6 +297,7 @@ namespace das {
         uint32_t                totalAllocated;
         uint32_t                maxAllocated;
         uint32_t                initialSize = 0;
+        uint64_t                bigStuffBytes = 0;
         Shoe                    shoe;
         das_hash_map<void *,uint32_t> bigStuff;  // note: can't use char *, some stl implementations try hashing it as string
 #if DAS_SANITIZER
@@ -366,20 +371,25 @@ namespace das {
             }
             return false;
         }
-        uint32_t depth() const;
-        uint64_t bytesAllocated() const;
-        uint64_t totalAlignedMemoryAllocated() const;
+        __forceinline uint32_t depth() const { return totalChunks; }
+        __forceinline uint64_t bytesAllocated() const { return bytesInUse; }
+        __forceinline uint64_t totalAlignedMemoryAllocated() const { return bytesReserved; }
         __forceinline void setInitialSize ( uint32_t size ) {
             initialSize = size;
         }
         virtual uint32_t grow ( uint32_t si );
     protected:
         void getStats ( uint32_t & depth, uint64_t & bytes, uint64_t & total ) const;
+        HeapChunk * newChunk ( uint32_t size, HeapChunk * next );
     public:
         CustomGrowFunction  customGrow;
         uint32_t    initialSize = 0;
         uint32_t    alignMask = 15;
         HeapChunk * chunk = nullptr;
+        // running counters, sum of offsets and sizes over all chunks
+        uint32_t    totalChunks = 0;
+        uint64_t    bytesInUse = 0;
+        uint64_t    bytesReserved = 0;
     };
 
 }
@@ -354,6 +354,12 @@ inline size_t das_aligned_memsize(void * ptr){
 #define DAS_MACRO_SANITIZER 0
 #endif
 
+// when enabled, TypeDecl, Expression, Variable, Structure, Enumeration and Function
+// can be allocated from the per-program NodeArena (see CodeOfPolicies::ast_arena)
+#ifndef DAS_AST_ARENA
+#define DAS_AST_ARENA 0
+#endif
+
 #if !_TARGET_64BIT && !defined(__clang__) && (_MSC_VER <= 1900)
 #define _msc_inline_bug __declspec(noinline)
 #else
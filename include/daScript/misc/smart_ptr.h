@@ -4,9 +4,7 @@
 #define DAS_SMART_PTR_ID    0
 #endif
 
-#if DAS_SMART_PTR_TRACKER
 #include <atomic>
-#endif
 #include <daScript/das_config.h>
 
 void os_debug_break();
@@ -404,6 +402,73 @@ namespace das {
         das_free(pdead);
     }
     };
+
+    // Arena for AST nodes. While arena is bound to the thread (see NodeArenaGuard), nodes are bump-allocated from it.
+    // Nodes deleted on the bound thread go to the free list of their size class, and are reused by the next allocation.
+    // Each chunk counts its live nodes. Once the owner (Program) calls release, free lists are dropped, and every chunk
+    // is returned to the system as soon as its last node is gone, so a node which escaped the program pins its chunk only.
+    class NodeArena {
+    public:
+        NodeArena ( const NodeArena & ) = delete;
+        NodeArena & operator = ( const NodeArena & ) = delete;
+        static NodeArena * create ( uint32_t initialSize = 64*1024 );
+        void release();
+        uint64_t bytesAllocated() const { return totalBytes; }
+        uint64_t bytesReserved() const { return reservedBytes; }
+        uint64_t nodesAllocated() const { return totalNodes; }
+        uint64_t nodesReused() const { return reusedNodes; }
+        // node allocation, with the 16 byte header which points to the owner chunk (or null, when arena is not bound)
+        static void * allocateNode ( size_t size );
+        static void freeNode ( void * ptr );
+        static DAS_THREAD_LOCAL NodeArena * bound;
+    protected:
+        enum { sizeClassShift = 4, numSizeClasses = 64 };   // 16 byte classes, up to 1Kb nodes are reused
+        struct Chunk {
+            NodeArena *     arena;
+            Chunk *         next;
+            Chunk *         prev;
+            uint32_t        size;
+            uint32_t        offset;
+            std::atomic<int32_t> live;
+        };
+        struct FreeNode {
+            FreeNode *      next;
+        };
+        NodeArena ( uint32_t initialSize );
+        ~NodeArena();
+        void * allocate ( size_t size, Chunk * & owner );
+        void freeChunkNode ( Chunk * ch );
+        void freeChunk ( Chunk * ch );
+        void delRef();
+        void lock();
+        void unlock();
+    protected:
+        Chunk *             chunk = nullptr;
+        uint32_t            chunkSize = 0;
+        uint64_t            totalBytes = 0;
+        uint64_t            reservedBytes = 0;
+        uint64_t            totalNodes = 0;
+        uint64_t            reusedNodes = 0;
+        bool                released = false;
+        FreeNode *          freeList[numSizeClasses] = {};
+        std::atomic<bool>   chunkLock{false};
+        std::atomic<int64_t> useCount{1};   // one for the owner, and one per chunk
+    };
+
+    struct NodeArenaGuard {
+        NodeArenaGuard ( NodeArena * arena ) { prev = NodeArena::bound; NodeArena::bound = arena; }
+        ~NodeArenaGuard () { NodeArena::bound = prev; }
+        NodeArena * prev;
+    };
+
+#if DAS_AST_ARENA
+    #define DAS_NODE_ARENA_NEW_DELETE \
+        static void * operator new ( size_t size ) { return NodeArena::allocateNode(size); } \
+        static void * operator new ( size_t, void * place ) { return place; } \
+        static void operator delete ( void * ptr ) { NodeArena::freeNode(ptr); } \
+        static void operator delete ( void *, void * ) { }
+#endif
+
     class ptr_ref_count : public IOperatorNewBase{
     public:
     
@@ -56,6 +56,8 @@ namespace das {
         virtual void append(const char * s, int l) override;
         virtual char * allocate (int l) override;
         virtual void output() override;
+        const char * c_data() const { return data; }
+        int32_t length() const { return size; }
     protected:
         char    data[DAS_SMALL_BUFFER_SIZE];
         int32_t size = 0;
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "daScript/simulate/simulate.h"
+
+namespace das {
+
+    // Sampled allocation profiler. It is installed on the context, and is called directly from Context::onAllocate and friends.
+    // Roughly one allocation per sampleInterval bytes is recorded, together with its call site and call stack (via Prologue chain).
+    // Sampled objects are tracked until freed, so every site knows how many of its objects are still alive.
+    class AllocationProfiler {
+    public:
+        struct StackFrame {
+            FuncInfo *  info = nullptr;
+            LineInfo *  line = nullptr;
+        };
+        struct Site {
+            LineInfo    at;
+            uint32_t    stackOffset = 0;    // in frames
+            uint32_t    stackSize = 0;
+            uint64_t    allocCount = 0;
+            uint64_t    allocBytes = 0;
+            uint64_t    liveCount = 0;
+            uint64_t    liveBytes = 0;
+            uint32_t    nextSameHash = ~0u;   // sites which share the hash of call site and stack
+        };
+        struct Sample {
+            uint32_t    site = 0;
+            uint64_t    size = 0;
+        };
+        struct SnapshotEntry {
+            uint32_t    site = 0;
+            uint64_t    liveCount = 0;
+            uint64_t    liveBytes = 0;
+        };
+        typedef vector<SnapshotEntry> Snapshot;
+    public:
+        AllocationProfiler ( uint64_t interval, int32_t maxDepth );
+        void onAllocate ( Context * context, void * ptr, uint64_t size, const LineInfo & at );
+        void onReallocate ( Context * context, void * ptr, void * newPtr, uint64_t newSize, const LineInfo & at );
+        void onFree ( void * ptr );
+        void onCollected ( Context * context );
+        void onHeapsReset();
+        int32_t takeSnapshot();
+        void reportJson ( TextWriter & tw ) const;
+        bool diffJson ( TextWriter & tw, int32_t fromSnapshot, int32_t toSnapshot ) const;
+        void reset();
+    public:
+        bool        prevInstrumentAllocations = false;  // restored when profiler stops
+    protected:
+        uint32_t captureSite ( Context * context, const LineInfo & at );
+        bool sameSite ( uint32_t si, const LineInfo & at, const StackFrame * stack, uint32_t depth ) const;
+        void writeSiteJson ( TextWriter & tw, uint32_t site ) const;
+    protected:
+        uint64_t                            sampleInterval;
+        int64_t                             bytesUntilSample;
+        int32_t                             maxStackDepth;
+        vector<Site>                        sites;
+        vector<StackFrame>                  frames;
+        das_hash_map<uint64_t,uint32_t>     siteLookup;
+        das_hash_map<void *,Sample>         samples;
+        vector<Snapshot>                    snapshots;
+        uint64_t                            totalCount = 0;
+        uint64_t                            totalBytes = 0;
+    };
+}
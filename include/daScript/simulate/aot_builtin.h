@@ -29,12 +29,17 @@ namespace das {
     void heap_stats ( Context & context, uint64_t * bytes );
     urange64 heap_allocation_stats ( Context * context );
     uint64_t heap_allocation_count ( Context * context );
+    urange64 heap_iterator_pool_stats ( Context * context );
     urange64 string_heap_allocation_stats ( Context * context );
     uint64_t string_heap_allocation_count ( Context * context );
     uint64_t heap_bytes_allocated ( Context * context );
     int32_t heap_depth ( Context * context );
     uint64_t string_heap_bytes_allocated ( Context * context );
     int32_t string_heap_depth ( Context * context );
+    uint64_t heap_high_watermark ( Context * context );
+    uint64_t string_heap_high_watermark ( Context * context );
+    void set_heap_telemetry ( bool enabled, Context * context );
+    bool is_heap_telemetry ( Context * context );
     void string_heap_report ( Context * context, LineInfoArg * info );
     bool is_intern_strings ( Context * context );
     void heap_collect ( bool stringHeap, bool validate, Context * context, LineInfoArg * info );
@@ -30,6 +30,13 @@ namespace das {
     void instrument_all_functions_thread_local_ex ( Context & ctx, const TBlock<uint64_t,Func,const SimFunction *> & blk, Context * context, LineInfoArg * arg );
     void clear_instruments ( Context & ctx );
 
+    bool is_context_allocations_instrumented ( Context & ctx );
+    void start_allocation_profiler ( Context & ctx, uint64_t sampleInterval, int32_t stackDepth );
+    void stop_allocation_profiler ( Context & ctx );
+    int32_t allocation_profiler_snapshot ( Context & ctx, Context * context, LineInfoArg * at );
+    char * allocation_profiler_report ( Context & ctx, Context * context, LineInfoArg * at );
+    char * allocation_profiler_diff ( Context & ctx, int32_t fromSnapshot, int32_t toSnapshot, Context * context, LineInfoArg * at );
+
     bool has_function ( Context & ctx, const char * name );
 
     int32_t set_hw_breakpoint ( Context & ctx, void * address, int32_t size, bool writeOnly );
@@ -21,6 +21,9 @@ namespace das {
     vec4f builtin_write ( Context &, SimNode_CallBase * call, vec4f * args );
     vec4f builtin_load ( Context & context, SimNode_CallBase *, vec4f * args );
     void builtin_map_file ( const FILE* _f, const TBlock<void, TTemporary<TArray<uint8_t>>>& blk, Context*, LineInfoArg * at );
+    void builtin_map_file_lines ( const FILE * f, const TBlock<void,TTemporary<char *>> & blk, Context * context, LineInfoArg * at );
+    void builtin_map_file_records ( const FILE * f, int32_t recordSeparator, int32_t fieldSeparator,
+        const TBlock<void,TTemporary<TArray<char *>>> & blk, Context * context, LineInfoArg * at );
     char * builtin_dirname ( const char * name, Context * context, LineInfoArg * at );
     char * builtin_basename ( const char * name, Context * context, LineInfoArg * at );
     bool builtin_fstat ( const FILE * f, FStat & fs, Context * context, LineInfoArg * at );
@@ -9,6 +9,14 @@ namespace das {
     bool das_is_jit_function ( const Func func );
     bool das_remove_jit ( const Func func );
     bool das_instrument_jit ( void * pfun, const Func func, Context & context );
+    bool das_install_jit ( void * pfun, const Func func, Context & context );    // caller holds the tier up code lock, if any
+    bool das_baseline_jit_available ();
+    bool das_baseline_jit_function ( const Func func, Context * context, LineInfoArg * at );
+    int32_t das_baseline_jit_context ( Context & ctx, bool log, Context * context, LineInfoArg * at );
+    void das_start_tier_up ( Context & ctx, uint64_t callThreshold, uint64_t loopThreshold, uint32_t intervalMs, Context * context, LineInfoArg * at );
+    void das_stop_tier_up ( Context & ctx );
+    int32_t das_tier_up_safe_point ( Context & ctx );
+    char * das_tier_up_report ( Context & ctx, int32_t maxFunctions, Context * context, LineInfoArg * at );
     void * das_instrument_line_info ( const LineInfo & info, Context * context, LineInfoArg * at );
     void * das_get_jit_exception ();
     void * das_get_jit_call_or_fastcall ();
@@ -40,6 +40,46 @@ namespace das {
         Feature box;
     };
 
+    // read-copy-update box for the read-mostly data. writers publish new version atomically,
+    // readers pin the current one without taking the lock. retired version is reclaimed
+    // once every reader which could have seen it is done (epoch based reclamation).
+    // reclaimed version is deleted only by the context which published it (see collect), so versions
+    // of the context which never calls collect stay in the box (along with that context) until the box is deleted
+    class RcuBox : public JobStatus {
+    public:
+        enum { numReaderSlots = 64 };
+        RcuBox();
+        virtual ~RcuBox();
+        void set ( void * data, TypeInfo * ti, Context * context );
+        void get ( const TBlock<void,void *> & blk, Context * context, LineInfoArg * at );
+        void update ( const TBlock<void *,void *> & blk, TypeInfo * ti, Context * context, LineInfoArg * at );
+        void collect ( const TBlock<void,void *> & blk, Context * context, LineInfoArg * at );
+        int32_t retired();
+    public:
+        template <typename TT>
+        void peek ( TT && tt ) {
+            lock_guard<mutex> guard(mCompleteMutex);
+            Feature * version = current.load();
+            if ( version && version->data ) {
+                tt(version->data, version->type, version->from.get());
+            }
+        }
+    protected:
+        void publish ( Feature * version );
+        void reclaim ();
+        static int readerSlot ();
+    protected:
+        // readers count themselves in the parity of the epoch they entered in
+        struct alignas(64) ReaderSlot {
+            atomic<int32_t> active[2];
+        };
+        ReaderSlot                      readers[numReaderSlots];
+        atomic<Feature *>               current;
+        atomic<uint64_t>                epoch;
+        vector<pair<Feature *,uint64_t>> retiredVersions;      // version, epoch it was retired in
+        vector<Feature *>               reclaimedVersions;    // no reader can see those, data is waiting for its context
+    };
+
     template <typename TT>
     class AtomicTT : public JobStatus {
     public:
@@ -54,6 +94,28 @@ namespace das {
     typedef AtomicTT<int32_t> AtomicInt;
     typedef AtomicTT<int64_t> AtomicInt64;
 
+    // block of memory, which does not belong to any context. producer fills it with messages, and it is
+    // passed through the channel as a whole. consumer reads messages in place, and releases them in bulk.
+    // nothing inside may point to the heap of a context, strings and arrays are allocated in the arena as well
+    class MessageArena {
+    public:
+        MessageArena ( uint32_t ps ) : pageSize(ps ? ps : 65536) {}
+        ~MessageArena();
+        char * allocate ( uint32_t size );
+        char * allocateString ( const char * str, uint32_t len );
+        uint64_t bytes() const { return totalBytes; }
+        int32_t messages() const { return int32_t(roots.size()); }
+        bool isValid() const { return pageSize!=0; }
+    public:
+        vector<void *>  roots;          // messages, in order they were pushed
+    protected:
+        vector<char *>  pages;
+        uint32_t        pageSize = 0;
+        uint32_t        pageOffset = 0;
+        uint32_t        pageCapacity = 0;
+        uint64_t        totalBytes = 0;
+    };
+
     class Channel : public JobStatus {
     public:
         Channel( Context * ctx ) : owner(ctx) {}
@@ -61,7 +123,9 @@ namespace das {
         virtual ~Channel();
         void push ( void * data, TypeInfo * ti, Context * context );
         void pushBatch ( void ** data, int count, TypeInfo * ti, Context * context );
+        void pushArena ( MessageArena * arena );
         void pop ( const TBlock<void,void *> & blk, Context * context, LineInfoArg * at );
+        MessageArena * popArena ( Context * context, LineInfoArg * at );
         bool isEmpty() const;
         int total() const;
         Context * getOwner() { return owner; }
@@ -70,14 +134,21 @@ namespace das {
         void for_each_item ( TT && tt ) {
             lock_guard<mutex> guard(mCompleteMutex);
             for ( auto & f : pipe ) {
-                tt(f.data, f.type, f.from ? f.from.get() : owner);
+                if ( f.type ) {     // arenas have no type, and are not on any heap
+                    tt(f.data, f.type, f.from ? f.from.get() : owner);
+                }
             }
         }
+        // gather is not typed. arenas are not handed to it, they are released along with the rest of the pipe
         template <typename TT>
         void gather ( TT && tt ) {
             lock_guard<mutex> guard(mCompleteMutex);
             for ( auto & f : pipe ) {
-                tt(f.data, f.type, f.from ? f.from.get() : owner);
+                if ( f.type ) {
+                    tt(f.data, f.type, f.from ? f.from.get() : owner);
+                } else {
+                    delete (MessageArena *) f.data;
+                }
             }
             pipe.clear();
         }
@@ -87,18 +158,25 @@ namespace das {
             for ( auto f = pipe.begin(); f != pipe.end(); ) {
                 auto itOwner = f->from ? f->from.get() : owner;
                 if ( itOwner == ctx ) {
-                    tt(f->data, f->type, itOwner);
+                    if ( f->type ) {
+                        tt(f->data, f->type, itOwner);
+                    } else {
+                        delete (MessageArena *) f->data;
+                    }
                     f = pipe.erase(f);
                 } else {
                     ++f;
                 }
             }
         }
+        // arenas are forwarded as they are
         template <typename TT>
         void gather_and_forward ( Channel * that, TT && tt ) {
             lock_guard<mutex> guard(mCompleteMutex);
             for ( auto & f : pipe ) {
-                tt(f.data, f.type, f.from ? f.from.get() : owner);
+                if ( f.type ) {
+                    tt(f.data, f.type, f.from ? f.from.get() : owner);
+                }
             }
             lock_guard<mutex> guard2(that->mCompleteMutex);
             for ( auto & f : pipe ) {
@@ -106,7 +184,11 @@ namespace das {
             }
             pipe.clear();
             that->mCond.notify_all();  // notify_one??
+            that->wakeWaiters();
         }
+    protected:
+        void waitForItem();
+        virtual bool isWaitOver() const override { return mRemaining==0 || !pipe.empty(); }
     protected:
         uint32_t            mSleepMs = 1;
         deque<Feature>      pipe;
@@ -114,10 +196,67 @@ namespace das {
         Context *           owner = nullptr;
     };
 
+    // Asynchronous file I/O. Requests are served by the dedicated pool of I/O threads, and completions are kept in C++ memory
+    // until the owner takes them. Completion of the request, which was submitted with the channel, is delivered by dispatch,
+    // otherwise it's taken by ticket. Channel is referenced until completion is delivered.
+    class AsyncIo : public JobStatus {
+    public:
+        enum class Op : int32_t { read, write, stat };
+        struct ChannelRef {
+            Channel * channel = nullptr;
+            ChannelRef() {}
+            ChannelRef ( Channel * ch ) : channel(ch) { if ( channel ) channel->addRef(); }
+            ChannelRef ( ChannelRef && r ) : channel(r.channel) { r.channel = nullptr; }
+            ChannelRef & operator = ( ChannelRef && r ) { std::swap(channel, r.channel); return *this; }
+            ~ChannelRef() { if ( channel ) channel->releaseRef(); }
+        };
+        struct Request {
+            Op              op = Op::read;
+            int64_t         ticket = 0;
+            vector<string>  paths;      // batch reads have more than one, tickets are consecutive
+            vector<uint8_t> data;       // write payload
+            ChannelRef      channel;
+        };
+        struct Completion {
+            int64_t         ticket = 0;
+            int32_t         error = 0;  // errno
+            uint64_t        size = 0;   // bytes read or written, file size for stat
+            int64_t         mtime = 0;
+            vector<uint8_t> data;
+            ChannelRef      channel;
+        };
+    public:
+        AsyncIo ( int32_t threads );
+        virtual ~AsyncIo();
+        int64_t submit ( Op op, vector<string> && paths, vector<uint8_t> && data, Channel * channel );
+        bool isDone ( int64_t ticket ) const;
+        bool waitFor ( int64_t ticket );
+        bool take ( int64_t ticket, Completion & res );
+        void dispatch ( bool wait, vector<Completion> & res );
+        int32_t pending() const;
+    protected:
+        void run();
+        void perform ( Request & req, vector<Completion> & res );
+    protected:
+        mutex                           requestLock;
+        condition_variable              requestCond;
+        deque<Request>                  requests;
+        bool                            stopping = false;
+        vector<std::thread>             workers;
+        atomic<int64_t>                 nextTicket{1};
+        int32_t                         pendingTickets = 0;     // under mCompleteMutex
+        int32_t                         pendingRouted = 0;
+        das_hash_map<int64_t,Completion*> ready;
+        vector<Completion>              routed;
+    };
+
     bool is_job_que_shutting_down();
     void new_job_invoke ( Lambda lambda, Func fn, int32_t lambdaSize, Context * context, LineInfoArg * lineinfo );
+    void new_job_pooled_invoke ( Lambda lambda, Func fn, int32_t lambdaSize, Context * context, LineInfoArg * lineinfo );
+    urange64 job_pool_stats ();
     void new_thread_invoke ( Lambda lambda, Func fn, int32_t lambdaSize, Context * context, LineInfoArg * lineinfo );
     void withJobQue ( const TBlock<void> & block, Context * context, LineInfoArg * lineInfo );
+    void parallelForInvoke ( int32_t from, int32_t to, int32_t chunkSize, int32_t maxThreads, const TBlock<void,int32_t,int32_t,int32_t> & block, Context * context, LineInfoArg * at );
     int getTotalHwJobs( Context * context, LineInfoArg * at );
     int getTotalHwThreads ();
     void withJobStatus ( int32_t total, const TBlock<void,JobStatus *> & block, Context * context, LineInfoArg * lineInfo );
@@ -128,6 +267,11 @@ namespace das {
     void waitForJob ( JobStatus * status, Context * context, LineInfoArg * at );
     void notifyJob ( JobStatus * status, Context * context, LineInfoArg * at );
     void notifyAndReleaseJob ( JobStatus * & status, Context * context, LineInfoArg * at );
+    JobWakeList * jobWakeListCreate ( Context * context, LineInfoArg * at );
+    void jobWakeListRemove ( JobWakeList * & list, Context * context, LineInfoArg * at );
+    void jobWakeOn ( JobStatus * status, JobWakeList * list, int32_t token, Context * context, LineInfoArg * at );
+    void jobWakeCancel ( JobStatus * status, JobWakeList * list, int32_t token, Context * context, LineInfoArg * at );
+    void jobWakeListDrain ( JobWakeList * list, const TBlock<void,int32_t> & blk, Context * context, LineInfoArg * at );
     vec4f channelPush ( Context & context, SimNode_CallBase * call, vec4f * args );
     vec4f channelPushBatch ( Context & context, SimNode_CallBase * call, vec4f * args );
     void channelPop ( Channel * ch, const TBlock<void,void*> & blk, Context * context, LineInfoArg * at );
@@ -147,6 +291,35 @@ namespace das {
     vec4f lockBoxSet ( Context & context, SimNode_CallBase * call, vec4f * args );
     void lockBoxGet ( LockBox * ch, const TBlock<void,void*> & blk, Context * context, LineInfoArg * at );
     void lockBoxUpdate ( LockBox * ch, TypeInfo * ti, const TBlock<void *,void*> & blk, Context * context, LineInfoArg * at );
+    RcuBox * rcuBoxCreate( Context *, LineInfoArg * );
+    void rcuBoxRemove( RcuBox * & box, Context * context, LineInfoArg * at );
+    void withRcuBox ( const TBlock<void,RcuBox *> & blk, Context * context, LineInfoArg * at );
+    vec4f rcuBoxSet ( Context & context, SimNode_CallBase * call, vec4f * args );
+    void rcuBoxGet ( RcuBox * box, const TBlock<void,void*> & blk, Context * context, LineInfoArg * at );
+    void rcuBoxUpdate ( RcuBox * box, TypeInfo * ti, const TBlock<void *,void*> & blk, Context * context, LineInfoArg * at );
+    void rcuBoxCollect ( RcuBox * box, const TBlock<void,void*> & blk, Context * context, LineInfoArg * at );
+    MessageArena * messageArenaCreate ( int32_t pageSize, Context * context, LineInfoArg * at );
+    void messageArenaRemove ( MessageArena * & arena, Context * context, LineInfoArg * at );
+    void * messageArenaAlloc ( MessageArena * arena, int32_t size, Context * context, LineInfoArg * at );
+    char * messageArenaString ( MessageArena * arena, const char * str, Context * context, LineInfoArg * at );
+    vec4f messageArenaArray ( Context & context, SimNode_CallBase * call, vec4f * args );
+    void messageArenaPush ( MessageArena * arena, void * data, Context * context, LineInfoArg * at );
+    void messageArenaForEach ( MessageArena * arena, const TBlock<void,void*> & blk, Context * context, LineInfoArg * at );
+    void messageArenaConsume ( MessageArena * & arena, const TBlock<void,void*> & blk, Context * context, LineInfoArg * at );
+    void channelPushArena ( Channel * ch, MessageArena * & arena, Context * context, LineInfoArg * at );
+    MessageArena * channelPopArena ( Channel * ch, Context * context, LineInfoArg * at );
+    AsyncIo * asyncIoCreate ( int32_t threads, Context * context, LineInfoArg * at );
+    void asyncIoRemove ( AsyncIo * & io, Context * context, LineInfoArg * at );
+    void withAsyncIo ( int32_t threads, const TBlock<void,AsyncIo *> & blk, Context * context, LineInfoArg * at );
+    int64_t asyncIoRead ( AsyncIo * io, const char * path, Channel * ch, Context * context, LineInfoArg * at );
+    int64_t asyncIoReadBatch ( AsyncIo * io, const TArray<char *> & paths, Channel * ch, Context * context, LineInfoArg * at );
+    int64_t asyncIoWrite ( AsyncIo * io, const char * path, const TArray<uint8_t> & data, Channel * ch, Context * context, LineInfoArg * at );
+    int64_t asyncIoStat ( AsyncIo * io, const char * path, Channel * ch, Context * context, LineInfoArg * at );
+    bool asyncIoDone ( AsyncIo * io, int64_t ticket, Context * context, LineInfoArg * at );
+    bool asyncIoJoin ( AsyncIo * io, int64_t ticket, Context * context, LineInfoArg * at );
+    bool asyncIoTake ( AsyncIo * io, int64_t ticket, const TBlock<void,int32_t,uint64_t,int64_t,TTemporary<TArray<uint8_t>>> & blk, Context * context, LineInfoArg * at );
+    int32_t asyncIoDispatch ( AsyncIo * io, bool wait,
+        const TBlock<void,int64_t,int32_t,uint64_t,int64_t,TTemporary<TArray<uint8_t>>,Channel *> & blk, Context * context, LineInfoArg * at );
 
     template <typename TT>
     AtomicTT<TT> * atomicCreate( Context *, LineInfoArg * ) {
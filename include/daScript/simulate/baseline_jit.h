@@ -0,0 +1,39 @@
+#pragma once
+
+#include "daScript/simulate/simulate.h"
+#include "daScript/simulate/simulate_nodes.h"
+
+// baseline jit emits SysV x86-64 code, and relies on longjmp based exceptions (there is no unwind info for generated code)
+#ifndef DAS_BASELINE_JIT
+    #if (defined(__x86_64__) || defined(_M_X64)) && !defined(_WIN32) && !DAS_ENABLE_EXCEPTIONS
+        #define DAS_BASELINE_JIT    1
+    #else
+        #define DAS_BASELINE_JIT    0
+    #endif
+#endif
+
+namespace das {
+
+    // Executable memory of the baseline JIT. It is shared between the context and its clones, since clones share simulated code.
+    // Every commit gets its own pages, which are never writable once committed. Tier up service commits on its own thread.
+    class BaselineJitCode {
+    public:
+        ~BaselineJitCode();
+        char * commit ( const uint8_t * data, uint32_t size );
+        uint64_t bytes() const { lock_guard<mutex> guard(lock); return totalBytes; }
+    protected:
+        mutable mutex   lock;
+        struct Page {
+            char *      data = nullptr;
+            uint64_t    size = 0;
+        };
+        vector<Page>    pages;
+        uint64_t        totalBytes = 0;
+    };
+
+    // LLVM-free baseline JIT. Translates common SimNode kinds (blocks, if, while, for range, integer math, comparisons, assignments, returns)
+    // into native code. Everything else is called back into the interpreter node by node, so any function can be compiled.
+    // Result[i] is null when function i is not worth compiling (builtin, aot, already jit, fastcall, or nothing native in it).
+    bool baselineJitAvailable();
+    bool baselineJitCompile ( Context & context, const vector<SimFunction *> & functions, vector<JitFunction> & result, TextWriter * log = nullptr );
+}
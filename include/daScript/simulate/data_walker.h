@@ -129,6 +129,52 @@ namespace das {
 
     typedef smart_ptr<DataWalker> DataWalkerPtr;
 
+    // Walk plan is a flat list of ops for the structure, compiled once from the StructInfo.
+    // Fields of by-value structures are inlined, adjacent plain data is merged into a single run,
+    // and anything other than plain data, strings, and enumerations is left to DataWalker::walk.
+    // Plan references StructInfo and VarInfo, and should not outlive them.
+    struct WalkPlanOp {
+        enum class Kind : uint8_t {
+            bytes,          // plain data run
+            string,
+            structure,      // start of the structure, before its fields
+            enumeration,
+            walk
+        };
+        Kind        kind;
+        uint32_t    offset;
+        uint32_t    size;
+        union {
+            StructInfo *    structInfo;
+            EnumInfo *      enumInfo;
+            TypeInfo *      typeInfo;
+        };
+    };
+
+    struct WalkPlan : public IOperatorNewBase {
+        vector<WalkPlanOp>  ops;
+        vector<WalkPlanOp>  gcOps;          // strings and walks, which can reference the heap
+        bool                hasGcWalk = false;
+        void compile ( StructInfo * si );
+    protected:
+        void addStructure ( StructInfo * si, uint32_t offset );
+        void addField ( TypeInfo * ti, uint32_t offset );
+        void addBytes ( uint32_t offset, uint32_t size );
+    };
+
+    class WalkPlanCache {
+    public:
+        const WalkPlan * get ( StructInfo * si );
+    protected:
+        das_hash_map<StructInfo *,WalkPlan *>   plans;
+        vector<unique_ptr<WalkPlan>>            storage;
+    };
+
+    // scalar or vector, which walker visits as is
+    bool isPlainWalkData ( TypeInfo * ti );
+    // by-value structure. classes resolve their type at runtime, so they are walked as is
+    bool canUseWalkPlan ( TypeInfo * ti );
+
 #if defined(_MSC_VER)
 #pragma warning(pop)
 #elif defined(__EDG__)
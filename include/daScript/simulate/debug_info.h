@@ -416,6 +416,15 @@ namespace das
         }
     };
 
+    // Source of the debug info which was not built during simulate (see 'lazy_debug_info' option).
+    // Fills in local and global variables of the function or block info on the first request.
+    class LazyDebugInfo {
+    public:
+        virtual ~LazyDebugInfo() {}
+        virtual void materialize ( FuncInfo * info ) = 0;
+        virtual void logMemInfo ( TextWriter & tw ) = 0;
+    };
+
     string das_to_string ( Type t );
     Type nameToBasicType(const string & name);
 
@@ -124,6 +124,63 @@ namespace das {
         uint32_t    stackSize = 0;
     };
 
+    // Heap telemetry is written only by the thread which runs the context, and can be read from any other thread
+    // without stopping the context. Each counter is consistent on its own, but counters are not consistent with each other.
+    // It is off by default (see 'heap_telemetry' option), and then every counter stays 0.
+    struct HeapTelemetry {
+        enum { num_size_classes = 16 };     // 16, 32, 64, ... 256K bytes, and everything bigger
+        HeapTelemetry() {
+            for ( auto & sc : sizeClassCount ) sc.store(0, std::memory_order_relaxed);
+        }
+        static __forceinline uint32_t sizeClass ( uint32_t size ) {
+            uint32_t sc = size<=16 ? 0 : (32 - das_clz(size-1)) - 4;
+            return sc<num_size_classes ? sc : num_size_classes-1;
+        }
+        // single writer, so there is no need for the interlocked add
+        static __forceinline void bump ( atomic<uint64_t> & value, uint64_t delta ) {
+            value.store(value.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+        }
+        static __forceinline void update ( atomic<uint64_t> & value, atomic<uint64_t> & peak, uint64_t newValue ) {
+            value.store(newValue, std::memory_order_relaxed);
+            if ( newValue > peak.load(std::memory_order_relaxed) ) peak.store(newValue, std::memory_order_relaxed);
+        }
+        __forceinline void onAllocate ( uint32_t size, uint64_t inUse, uint64_t reserved ) {
+            if ( !enabled ) return;
+            bump(sizeClassCount[sizeClass(size)], 1);
+            update(bytesInUse, peakBytesInUse, inUse);
+            update(bytesReserved, peakBytesReserved, reserved);
+        }
+        __forceinline void onFree ( uint64_t inUse ) {
+            if ( !enabled ) return;
+            bytesInUse.store(inUse, std::memory_order_relaxed);
+        }
+        __forceinline void onReset ( uint64_t inUse, uint64_t reserved ) {
+            if ( !enabled ) return;
+            update(bytesInUse, peakBytesInUse, inUse);
+            update(bytesReserved, peakBytesReserved, reserved);
+        }
+        __forceinline void onCollect ( uint64_t inUseBefore, uint64_t inUse, uint64_t reserved ) {
+            if ( !enabled ) return;
+            bump(gcCount, 1);
+            bump(gcBytesCollected, inUseBefore>inUse ? inUseBefore-inUse : 0);
+            onReset(inUse, reserved);
+        }
+        // share of reserved memory, which is not in use. 0 when everything is used
+        double fragmentation() const {
+            uint64_t reserved = bytesReserved.load(std::memory_order_relaxed);
+            uint64_t inUse = bytesInUse.load(std::memory_order_relaxed);
+            return (reserved && inUse<reserved) ? double(reserved-inUse) / double(reserved) : 0.0;
+        }
+        bool             enabled = false;
+        atomic<uint64_t> sizeClassCount[num_size_classes];
+        atomic<uint64_t> bytesInUse{0};
+        atomic<uint64_t> peakBytesInUse{0};
+        atomic<uint64_t> bytesReserved{0};
+        atomic<uint64_t> peakBytesReserved{0};
+        atomic<uint64_t> gcCount{0};
+        atomic<uint64_t> gcBytesCollected{0};
+    };
+
     class AnyHeapAllocator : public ptr_ref_count {
     public:
         virtual bool breakOnFree ( void *, uint32_t ) { return false; }
@@ -148,6 +205,13 @@ namespace das {
         __forceinline uint64_t getTotalAllocations() const { return totalAllocations; }
         __forceinline uint64_t getTotalBytesAllocated() const { return totalBytesAllocated; }
         __forceinline uint64_t getTotalBytesDeleted() const { return totalBytesDeleted; }
+        __forceinline const HeapTelemetry & getTelemetry() const { return telemetry; }
+        __forceinline bool isTelemetryEnabled() const { return telemetry.enabled; }
+        __forceinline void setTelemetryEnabled ( bool on ) {
+            telemetry.enabled = on;
+            telemetry.onReset(bytesAllocated(), totalAlignedMemoryAllocated());     // counters pick up from the current state
+        }
+        __forceinline void onCollected ( uint64_t inUseBefore ) { telemetry.onCollect(inUseBefore, bytesAllocated(), totalAlignedMemoryAllocated()); }
     public:
 #if DAS_TRACK_ALLOCATIONS
         virtual void mark_location ( void *, const LineInfo * )  {}
@@ -160,11 +224,23 @@ namespace das {
         char * allocateName ( const string & name );
         char * impl_allocateIterator ( uint32_t size, const char * name="", const LineInfo * info=nullptr );
         void   impl_freeIterator ( char * ptr );
+        void   flushIteratorPool();                 // pooled iterators go back to the heap, i.e. before GC
+        void   dropIteratorPool();                  // pooled iterators are forgotten, when heap is reset
+        __forceinline uint64_t getIteratorPoolHits() const { return iteratorPoolHits; }
+        __forceinline uint64_t getIteratorPoolBytes() const { return iteratorPoolBytes; }
+    protected:
+        // freed iterators are kept in per size free lists, and reused without going through the heap
+        enum { iteratorPoolSizes = 16, iteratorPoolDepth = 64 };    // up to 256 bytes, in 16 byte steps
+        char *   iteratorPool[iteratorPoolSizes] = {};
+        uint32_t iteratorPoolCount[iteratorPoolSizes] = {};
+        uint64_t iteratorPoolHits = 0;
+        uint64_t iteratorPoolBytes = 0;
     protected:
         uint64_t limit = 0;
         uint64_t totalAllocations = 0;
         uint64_t totalBytesAllocated = 0;
         uint64_t totalBytesDeleted = 0;
+        HeapTelemetry telemetry;
     };
 
     struct StrHashEntry {
@@ -240,6 +316,7 @@ namespace das {
         virtual void impl_free ( char * ptr, uint32_t size ) override {
             totalBytesDeleted += size;
             model.free(ptr,size);
+            telemetry.onFree(model.bytesAllocated());
         }
         virtual void sweep() override { model.sweep(); }
 #endif
@@ -249,7 +326,9 @@ namespace das {
             if ( limit==0 || model.bytesAllocated()+size<=limit ) {
                 totalAllocations ++;
                 totalBytesAllocated += size;
-                return model.allocate(size);
+                char * ptr = model.allocate(size);
+                telemetry.onAllocate(size, model.bytesAllocated(), model.totalAlignedMemoryAllocated());
+                return ptr;
             } else {
                 return nullptr;
             }
@@ -258,7 +337,9 @@ namespace das {
             if ( limit==0 || model.bytesAllocated()+newSize-oldSize<=limit ) {
                 totalAllocations ++;
                 totalBytesAllocated += newSize-oldSize;
-                return model.reallocate(ptr,oldSize,newSize);
+                char * nptr = model.reallocate(ptr,oldSize,newSize);
+                telemetry.onAllocate(newSize, model.bytesAllocated(), model.totalAlignedMemoryAllocated());
+                return nptr;
             } else {
                 return nullptr;
             }
@@ -266,7 +347,7 @@ namespace das {
         virtual int depth() const override { return model.depth(); }
         virtual uint64_t bytesAllocated() const override { return model.bytesAllocated(); }
         virtual uint64_t totalAlignedMemoryAllocated() const override { return model.totalAlignedMemoryAllocated(); }
-        virtual void reset() override { model.reset(); }
+        virtual void reset() override { model.reset(); telemetry.onReset(model.bytesAllocated(), model.totalAlignedMemoryAllocated()); }
         virtual void report() override;
         virtual bool mark() override;
         virtual bool mark ( char * ptr, uint32_t size ) override;
@@ -290,7 +371,9 @@ namespace das {
             if ( limit==0 || model.bytesAllocated()+size<=limit ) {
                 totalAllocations ++;
                 totalBytesAllocated += size;
-                return model.allocate(size);
+                char * ptr = model.allocate(size);
+                telemetry.onAllocate(size, model.bytesAllocated(), model.totalAlignedMemoryAllocated());
+                return ptr;
             } else {
                 return nullptr;
             }
@@ -298,12 +381,15 @@ namespace das {
         virtual void impl_free ( char * ptr, uint32_t size ) override {
             totalBytesDeleted += size;
             model.free(ptr,size);
+            telemetry.onFree(model.bytesAllocated());
         }
         virtual char * impl_reallocate ( char * ptr, uint32_t oldSize, uint32_t newSize ) override {
             if ( limit==0 || model.bytesAllocated()+newSize-oldSize<=limit ) {
                 totalAllocations ++;
                 totalBytesAllocated += newSize-oldSize;
-                return model.reallocate(ptr,oldSize,newSize);
+                char * nptr = model.reallocate(ptr,oldSize,newSize);
+                telemetry.onAllocate(newSize, model.bytesAllocated(), model.totalAlignedMemoryAllocated());
+                return nptr;
             } else {
                 return nullptr;
             }
@@ -311,7 +397,7 @@ namespace das {
         virtual int depth() const override { return model.depth(); }
         virtual uint64_t bytesAllocated() const override { return model.bytesAllocated(); }
         virtual uint64_t totalAlignedMemoryAllocated() const override { return model.totalAlignedMemoryAllocated(); }
-        virtual void reset() override { model.reset(); }
+        virtual void reset() override { model.reset(); telemetry.onReset(model.bytesAllocated(), model.totalAlignedMemoryAllocated()); }
         virtual void report() override;
         virtual bool mark() override { return false; }
         virtual bool mark ( char *, uint32_t ) override { DAS_ASSERT(0 && "not supported"); return false; }
@@ -351,7 +437,9 @@ namespace das {
             if ( limit==0 || model.bytesAllocated()+size<=limit ) {
                 totalAllocations ++;
                 totalBytesAllocated += size;
-                return model.allocate(size);
+                char * ptr = model.allocate(size);
+                telemetry.onAllocate(size, model.bytesAllocated(), model.totalAlignedMemoryAllocated());
+                return ptr;
             } else {
                 return nullptr;
             }
@@ -359,12 +447,15 @@ namespace das {
         virtual void impl_free ( char * ptr, uint32_t size ) override {
             totalBytesDeleted += size;
             model.free(ptr,size);
+            telemetry.onFree(model.bytesAllocated());
         }
         virtual char * impl_reallocate ( char * ptr, uint32_t oldSize, uint32_t newSize ) override {
             if ( limit==0 || model.bytesAllocated()+newSize-oldSize<=limit ) {
                 totalAllocations ++;
                 totalBytesAllocated += newSize-oldSize;
-                return model.reallocate(ptr,oldSize,newSize);
+                char * nptr = model.reallocate(ptr,oldSize,newSize);
+                telemetry.onAllocate(newSize, model.bytesAllocated(), model.totalAlignedMemoryAllocated());
+                return nptr;
             } else {
                 return nullptr;
             }
@@ -372,7 +463,7 @@ namespace das {
         virtual int depth() const override { return model.depth(); }
         virtual uint64_t bytesAllocated() const override { return model.bytesAllocated(); }
         virtual uint64_t totalAlignedMemoryAllocated() const override { return model.totalAlignedMemoryAllocated(); }
-        virtual void reset() override { model.reset(); }
+        virtual void reset() override { model.reset(); telemetry.onReset(model.bytesAllocated(), model.totalAlignedMemoryAllocated()); }
         virtual void forEachString ( const callable<void (const char *)> & fn ) override ;
         virtual void report() override;
         virtual bool mark() override;
@@ -398,7 +489,9 @@ namespace das {
             if ( limit==0 || model.bytesAllocated()+size<=limit ) {
                 totalAllocations ++;
                 totalBytesAllocated += size;
-                return model.allocate(size);
+                char * ptr = model.allocate(size);
+                telemetry.onAllocate(size, model.bytesAllocated(), model.totalAlignedMemoryAllocated());
+                return ptr;
             } else {
                 return nullptr;
             }
@@ -406,12 +499,15 @@ namespace das {
         virtual void impl_free ( char * ptr, uint32_t size ) override {
             totalBytesDeleted += size;
             model.free(ptr,size);
+            telemetry.onFree(model.bytesAllocated());
         }
         virtual char * impl_reallocate ( char * ptr, uint32_t oldSize, uint32_t newSize ) override {
             if ( limit==0 || model.bytesAllocated()+newSize-oldSize<=limit ) {
                 totalAllocations ++;
                 totalBytesAllocated += newSize-oldSize;
-                return model.reallocate(ptr,oldSize,newSize);
+                char * nptr = model.reallocate(ptr,oldSize,newSize);
+                telemetry.onAllocate(newSize, model.bytesAllocated(), model.totalAlignedMemoryAllocated());
+                return nptr;
             } else {
                 return nullptr;
             }
@@ -419,7 +515,7 @@ namespace das {
         virtual int depth() const override { return model.depth(); }
         virtual uint64_t bytesAllocated() const override { return model.bytesAllocated(); }
         virtual uint64_t totalAlignedMemoryAllocated() const override { return model.totalAlignedMemoryAllocated(); }
-        virtual void reset() override { model.reset(); }
+        virtual void reset() override { model.reset(); telemetry.onReset(model.bytesAllocated(), model.totalAlignedMemoryAllocated()); }
         virtual void forEachString ( const callable<void (const char *)> & fn ) override;
         virtual void report() override;
         virtual bool mark() override { return false; }
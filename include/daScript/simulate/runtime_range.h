@@ -136,6 +136,7 @@ namespace das
         baseType * pi = (baseType *)(context.stack.sp() + this->stackTop[0]);
         baseType r_to = r.to;
         if ( r.from >= r_to ) goto loopend;
+        DAS_COUNT_BACKEDGES(r_to - r.from)
         { SimNode ** __restrict tail = this->list + this->total;
         for (baseType i = r.from; i != r_to; ++i) {
             *pi = i;
@@ -161,6 +162,7 @@ namespace das
         baseType * pi = (baseType *)(context.stack.sp() + this->stackTop[0]);
         baseType r_to = r.to;
         if ( r.from >= r_to ) goto loopend;
+        DAS_COUNT_BACKEDGES(r_to - r.from)
         { SimNode ** __restrict tail = this->list + this->total;
         for (baseType i = r.from; i != r_to; ++i) {
             *pi = i;
@@ -183,6 +185,7 @@ namespace das
         baseType * pi = (baseType *)(context.stack.sp() + this->stackTop[0]);
         baseType r_to = r.to;
         if ( r.from >= r_to ) goto loopend;
+        DAS_COUNT_BACKEDGES(r_to - r.from)
         { SimNode * __restrict pbody = this->list[0];
         for (baseType i = r.from; i != r_to; ++i) {
             *pi = i;
@@ -204,6 +207,7 @@ namespace das
         baseType * pi = (baseType *)(context.stack.sp() + this->stackTop[0]);
         baseType r_to = r.to;
         if ( r.from >= r_to ) goto loopend;
+        DAS_COUNT_BACKEDGES(r_to - r.from)
         { SimNode * __restrict pbody = this->list[0];
         for (baseType i = r.from; i != r_to; ++i) {
             *pi = i;
@@ -230,6 +234,7 @@ namespace das
         baseType * pi = (baseType *)(context.stack.sp() + this->stackTop[0]);
         baseType r_to = r.to;
         if ( r.from >= r_to ) goto loopend;
+        DAS_COUNT_BACKEDGES(r_to - r.from)
         { SimNode ** __restrict tail = this->list + this->total;
         for (baseType i = r.from; i != r_to; ++i) {
             *pi = i;
@@ -256,6 +261,7 @@ namespace das
         baseType * pi = (baseType *)(context.stack.sp() + this->stackTop[0]);
         baseType r_to = r.to;
         if ( r.from >= r_to ) goto loopend;
+        DAS_COUNT_BACKEDGES(r_to - r.from)
         { SimNode ** __restrict tail = this->list + this->total;
         for (baseType i = r.from; i != r_to; ++i) {
             *pi = i;
@@ -279,6 +285,7 @@ namespace das
         baseType * pi = (baseType *)(context.stack.sp() + this->stackTop[0]);
         baseType r_to = r.to;
         if ( r.from >= r_to ) goto loopend;
+        DAS_COUNT_BACKEDGES(r_to - r.from)
         {
         for (baseType i = r.from; i != r_to; ++i) {
             *pi = i;
@@ -302,6 +309,7 @@ namespace das
         baseType * pi = (baseType *)(context.stack.sp() + this->stackTop[0]);
         baseType r_to = r.to;
         if ( r.from >= r_to ) goto loopend;
+        DAS_COUNT_BACKEDGES(r_to - r.from)
         {
         for (baseType i = r.from; i != r_to; ++i) {
             *pi = i;
@@ -31,6 +31,28 @@ namespace das
     #define DAS_ENABLE_EXCEPTIONS   0
     #endif
 
+    #ifndef DAS_TIERED_EXECUTION
+    #define DAS_TIERED_EXECUTION    1
+    #endif
+
+    // counters are only updated while the tier up service runs on the context. loop iterations are attributed to the function
+    // which runs the loop. callee restores the backedge counter on exit, so that caller only sees its own iterations.
+    // when exception unwinds the call, scope guard restores it. with longjmp there is no unwinding, and the catch site does it
+    #if DAS_TIERED_EXECUTION
+        #define DAS_COUNT_BACKEDGES(n)  if ( context.tierUp ) context.loopBackedges += uint64_t(n);
+        #if DAS_ENABLE_EXCEPTIONS
+            #define DAS_TIER_ENTER(fn)      TierScope tierScope(*this, fn)
+            #define DAS_TIER_LEAVE(fn)
+        #else
+            #define DAS_TIER_ENTER(fn)      auto tierBackedges = loopBackedges; if ( tierUp ) fn->countCall()
+            #define DAS_TIER_LEAVE(fn)      if ( tierUp ) fn->countLoops(loopBackedges - tierBackedges); loopBackedges = tierBackedges
+        #endif
+    #else
+        #define DAS_COUNT_BACKEDGES(n)
+        #define DAS_TIER_ENTER(fn)
+        #define DAS_TIER_LEAVE(fn)
+    #endif
+
     #if DAS_ENABLE_PROFILER
         #define DAS_PROFILE_NODE    profileNode(this);
     #else
@@ -41,6 +63,9 @@ namespace das
     struct SimNode;
     struct Block;
     struct SimVisitor;
+    class AllocationProfiler;
+    class BaselineJitCode;
+    class TierUpService;
 
     enum class ContextCategory : uint32_t {
         none =              0
@@ -91,7 +116,14 @@ namespace das
                 bool    pinvoke : 1;
             };
         };
+        mutable atomic<uint64_t>    callCount;      // tiered execution counters. clones share functions, and tier up service reads them
+        mutable atomic<uint64_t>    loopCount;
         const LineInfo * getLineInfo() const;
+        // only the context which runs the tier up service counts (not its clones), so its thread is the only writer
+        __forceinline void countCall() const { callCount.store(callCount.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed); }
+        __forceinline void countLoops ( uint64_t n ) const { if ( n ) loopCount.store(loopCount.load(std::memory_order_relaxed) + n, std::memory_order_relaxed); }
+        uint64_t getCallCount() const { return callCount.load(std::memory_order_relaxed); }
+        uint64_t getLoopCount() const { return loopCount.load(std::memory_order_relaxed); }
     };
 
     struct SimNode {
@@ -270,6 +302,16 @@ namespace das
 
     typedef shared_ptr<Context> ContextPtr;
 
+#if DAS_TIERED_EXECUTION && DAS_ENABLE_EXCEPTIONS
+    struct TierScope {
+        __forceinline TierScope ( Context & ctx, const SimFunction * fn );
+        __forceinline ~TierScope();
+        Context &           context;
+        const SimFunction * fn;
+        uint64_t            backedges;
+    };
+#endif
+
     class Context : public ptr_ref_count, public enable_shared_from_this<Context> {
         template <typename TT> friend struct SimNode_GetGlobalR2V;
         friend struct SimNode_GetGlobal;
@@ -299,6 +341,7 @@ namespace das
         void onAllocate ( void * ptr, uint64_t size, const LineInfo & at );
         void onReallocate ( void * ptr, uint64_t size, void * newPtr, uint64_t newSize, const LineInfo & at );
         void onFree ( void * ptr, const LineInfo & at );
+        void onHeapsReset();
 
         __forceinline char * allocateIterator ( uint32_t size, const char * iterName, const LineInfo * at ) {
             if ( instrumentAllocations ) {
@@ -380,6 +423,12 @@ namespace das
             }
         }
 
+        // local and global variables of the info may not be there yet, if debug info is lazy
+        __forceinline FuncInfo * requireDebugInfo ( FuncInfo * info ) const {
+            if ( lazyDebugInfo && info ) lazyDebugInfo->materialize(info);
+            return info;
+        }
+
         __forceinline VarInfo * getVariableInfo( int index ) const {
             return (uint32_t(index)<uint32_t(totalVariables)) ? globalVariables[index].debugInfo  : nullptr;;
         }
@@ -397,9 +446,11 @@ namespace das
 
         __forceinline void restartHeaps() {
             DAS_ASSERTF(insideContext==0,"can't reset heaps in locked context");
+            heap->dropIteratorPool();
             heap->reset();
             stringHeap->reset();
             stringDisposeQue = nullptr;
+            if ( allocProfiler ) onHeapsReset();
         }
 
         __forceinline uint32_t tryRestartAndLock() {
@@ -432,6 +483,8 @@ namespace das
 
         DAS_EVAL_ABI vec4f ___noinline evalWithCatch ( SimFunction * fnPtr, vec4f * args = nullptr, void * res = nullptr );
         DAS_EVAL_ABI vec4f ___noinline evalWithCatch ( SimNode * node );
+        // returns number of completed calls, or -1 (with exception set) if fnPtr returns via cmres
+        int32_t ___noinline evalBatchWithCatch ( SimFunction * fnPtr, vec4f * args, int32_t argStride, int32_t count, vec4f * results );
         bool ___noinline runWithCatch ( const callable<void()> & subexpr );
         DAS_NORETURN_PREFIX void throw_error ( const char * message ) DAS_NORETURN_SUFFIX;
         DAS_NORETURN_PREFIX void throw_error_ex ( DAS_FORMAT_STRING_PREFIX const char * message, ... ) DAS_NORETURN_SUFFIX DAS_FORMAT_PRINT_ATTRIBUTE(2,3);
@@ -447,6 +500,9 @@ namespace das
         __forceinline int32_t getTotalFunctions() const {
             return totalFunctions;
         }
+        __forceinline bool hasDebugger() const {
+            return debugger;
+        }
         __forceinline int32_t getTotalVariables() const {
             return totalVariables;
         }
@@ -475,6 +531,8 @@ namespace das
         string getStackWalk ( const LineInfo * at, bool showArguments, bool showLocalVariables, bool showOutOfScope = false, bool stackTopOnly = false );
         void runInitScript ();
         bool runShutdownScript ();
+        bool snapshotGlobals ( vector<char> & snapshot ) const;
+        void recycle ( const vector<char> * globalsSnapshot );
 
         virtual void to_out ( const LineInfo * at, const char * message );   // output to stdout or equivalent
         virtual void to_err ( const LineInfo * at, const char * message );   // output to stderr or equivalent
@@ -517,7 +575,9 @@ namespace das
             pp->line = line;
 #endif
             // CALL
+            DAS_TIER_ENTER(fn);
             fn->code->eval(*this);
+            DAS_TIER_LEAVE(fn);
             stopFlags = 0;
             // POP
             abiArg = aa;
@@ -529,7 +589,9 @@ namespace das
             if ( fn->fastcall ) {
                 auto aa = abiArg;
                 abiArg = args;
+                DAS_TIER_ENTER(fn);
                 result = fn->code->eval(*this);
+                DAS_TIER_LEAVE(fn);
                 stopFlags = 0;
                 abiArg = aa;
                 return result;
@@ -553,7 +615,9 @@ namespace das
                 pp->line = line;
 #endif
                 // CALL
+                DAS_TIER_ENTER(fn);
                 fn->code->eval(*this);
+                DAS_TIER_LEAVE(fn);
                 stopFlags = 0;
                 // POP
                 abiArg = aa;
@@ -582,7 +646,9 @@ namespace das
             pp->line = line;
 #endif
             // CALL
+            DAS_TIER_ENTER(fn);
             fn->code->eval(*this);
+            DAS_TIER_LEAVE(fn);
             stopFlags = 0;
             // POP
             abiArg = aa; abiCMRES = acm;
@@ -590,6 +656,42 @@ namespace das
             return result;
         }
 
+        // calls fn count times, arguments of call i start at args + i*argStride
+        // stack frame is pushed once and reused for the whole batch, done is the number of completed calls
+        DAS_EVAL_ABI __forceinline void callBatch(const SimFunction * fn, vec4f * args, int32_t argStride, int32_t count, vec4f * results, volatile int32_t & done, LineInfo * line) {
+            // PUSH
+            char * EP, *SP;
+            if (!stack.push(fn->stackSize, EP, SP)) {
+                throw_error_at(line, "stack overflow while calling %s",fn->mangledName);
+            }
+            auto aa = abiArg; auto acm = abiCMRES;
+            abiCMRES = nullptr;
+            for ( int32_t i=0; i!=count; ++i ) {
+                vec4f * fnArgs = args + size_t(i) * argStride;
+                abiArg = fnArgs;
+#if DAS_SANITIZER
+                memset(stack.sp(), 0xcd, fn->stackSize);
+#endif
+#if DAS_ENABLE_STACK_WALK
+                Prologue * pp = (Prologue *)stack.sp();
+                pp->info = fn->debugInfo;
+                pp->arguments = fnArgs;
+                pp->cmres = nullptr;
+                pp->line = line;
+#endif
+                // CALL
+                DAS_TIER_ENTER(fn);
+                fn->code->eval(*this);
+                DAS_TIER_LEAVE(fn);
+                stopFlags = 0;
+                if ( results ) results[i] = result;
+                done = i + 1;
+            }
+            // POP
+            abiArg = aa; abiCMRES = acm;
+            stack.pop(EP, SP);
+        }
+
 #ifdef _MSC_VER
 #pragma warning(push)
 #pragma warning(disable:4701)
@@ -737,6 +839,7 @@ namespace das
         shared_ptr<ConstStringAllocator> constStringHeap;
         shared_ptr<NodeAllocator>       code;
         shared_ptr<DebugInfoAllocator>  debugInfo;
+        shared_ptr<LazyDebugInfo>       lazyDebugInfo;          // shared with clones, same as debugInfo
         char *                          stringDisposeQue = nullptr;
         uint64_t *                      annotationData = nullptr;
         char *                          globals = nullptr;
@@ -795,9 +898,13 @@ namespace das
     public:
         vec4f result;
         uint32_t stopFlags = 0;
+        uint64_t loopBackedges = 0;
         uint32_t gotoLabel = 0;
     public:
         recursive_mutex * contextMutex = nullptr;
+        AllocationProfiler * allocProfiler = nullptr;
+        shared_ptr<BaselineJitCode> baselineJitCode;    // shared with clones, same as functions
+        TierUpService * tierUp = nullptr;
     protected:
         das_hash_map<void *, TypeInfo *> gcRoots;
     public:
@@ -808,6 +915,16 @@ namespace das
 #endif
     };
 
+#if DAS_TIERED_EXECUTION && DAS_ENABLE_EXCEPTIONS
+    __forceinline TierScope::TierScope ( Context & ctx, const SimFunction * f ) : context(ctx), fn(f), backedges(ctx.loopBackedges) {
+        if ( context.tierUp ) fn->countCall();
+    }
+    __forceinline TierScope::~TierScope() {
+        if ( context.tierUp ) fn->countLoops(context.loopBackedges - backedges);
+        context.loopBackedges = backedges;
+    }
+#endif
+
     struct DebugAgentInstance {
         DebugAgentPtr   debugAgent;
         ContextPtr      debugAgentContext;
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "daScript/simulate/simulate.h"
+#include "daScript/simulate/simulate_nodes.h"
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+namespace das {
+
+    // Tiered execution. Background thread watches per-function call and loop counters (see DAS_TIER_ENTER),
+    // and compiles functions which crossed either threshold with the baseline JIT. Compiled code is installed by safePoint(),
+    // which must be called on the thread which runs the context. Promotion happens only there (tier_up_safe_point in the script):
+    // calls and loops never install code on their own, so the host calls it where it is safe to swap code, i.e. once per frame.
+    // Functions which are already on the stack keep running the interpreted code, next call goes native.
+    // Counters are relaxed atomics, they are only hints.
+    // Code of the functions is read by the compiler under the code lock. Anything else, which replaces SimFunction::code
+    // while the service is running (das_instrument_jit, baseline_jit), takes the same lock.
+    class TierUpService {
+    public:
+        enum class Tier : uint8_t {
+            interpreted,    // not hot yet
+            native,         // aot or jit before the service started
+            compiled,       // waiting for the safe point
+            promoted,       // running baseline jit code
+            rejected        // nothing to compile, or no baseline jit on this platform
+        };
+    public:
+        TierUpService ( Context & ctx, uint64_t callThreshold, uint64_t loopThreshold, uint32_t intervalMs );
+        ~TierUpService();
+        int32_t safePoint();
+        void reportJson ( TextWriter & tw, int32_t maxFunctions ) const;
+        mutex & getCodeLock() { return codeLock; }
+    protected:
+        void run();
+        void scan();
+    protected:
+        Context &                       context;
+        uint64_t                        callThreshold;
+        uint64_t                        loopThreshold;
+        uint32_t                        intervalMs;
+        vector<Tier>                    tiers;          // by function index
+        vector<pair<int32_t,JitFunction>> ready;
+        uint64_t                        totalPromoted = 0;
+        mutable mutex                   lock;
+        mutex                           codeLock;       // compiler reads the code, safe point and jit install replace it
+        condition_variable              wake;
+        std::atomic<bool>               stopping { false };
+        std::thread                     worker;
+    };
+}
@@ -69,6 +69,284 @@ int sqlite3_bind_text_ ( sqlite3_stmt * stmt, int index, const char * data ) {
     return sqlite3_bind_text(stmt, index, data, -1, SQLITE_TRANSIENT);
 }
 
+// Bulk fetch and insert. Columns (or statement parameters) are matched to the fields of the structure by name once per call,
+// and then every row is converted without returning to the script. Text is copied to the string heap of the calling context.
+
+struct SqliteFieldMap {
+    int32_t     column;     // result column, or statement parameter
+    uint32_t    offset;     // of the field
+    uint32_t    stride;     // columnar fetch, size of the array element
+    Type        type;
+};
+
+static bool sqlite_mappable ( Type type ) {
+    switch ( type ) {
+    case Type::tBool:
+    case Type::tInt8:   case Type::tUInt8:
+    case Type::tInt16:  case Type::tUInt16:
+    case Type::tInt:    case Type::tUInt:
+    case Type::tInt64:  case Type::tUInt64:
+    case Type::tFloat:  case Type::tDouble:
+    case Type::tString:
+        return true;
+    default:
+        return false;
+    }
+}
+
+static VarInfo * sqlite_find_field ( StructInfo * si, const char * name ) {
+    if ( !name ) return nullptr;
+    for ( uint32_t i=0; i!=si->count; ++i ) {
+        if ( strcmp(si->fields[i]->name, name)==0 ) return si->fields[i];
+    }
+    return nullptr;
+}
+
+static void sqlite_map_field ( vector<SqliteFieldMap> & map, int32_t column, VarInfo * field, StructInfo * si, bool columnar, Context & context, LineInfo * at ) {
+    SqliteFieldMap fm;
+    fm.column = column;
+    fm.offset = field->offset;
+    fm.stride = 0;
+    fm.type = field->type;
+    if ( columnar ) {
+        if ( field->type!=Type::tArray || !field->firstType ) {
+            context.throw_error_at(at, "field %s of %s is not an array", field->name, si->name);
+        }
+        fm.type = field->firstType->type;
+        fm.stride = getTypeSize(field->firstType);
+    }
+    if ( !sqlite_mappable(fm.type) ) {
+        context.throw_error_at(at, "field %s of %s can't be mapped to the sqlite column", field->name, si->name);
+    }
+    map.push_back(fm);
+}
+
+static void sqlite_map_columns ( sqlite3_stmt * stmt, StructInfo * si, bool columnar, vector<SqliteFieldMap> & map, Context & context, LineInfo * at ) {
+    int ncol = sqlite3_column_count(stmt);
+    for ( int c=0; c!=ncol; ++c ) {
+        if ( auto field = sqlite_find_field(si, sqlite3_column_name(stmt, c)) ) {
+            sqlite_map_field(map, c, field, si, columnar, context, at);
+        }
+    }
+}
+
+// named parameters (:name, @name, $name) are matched by name, anonymous ones by position
+static void sqlite_map_parameters ( sqlite3_stmt * stmt, StructInfo * si, vector<SqliteFieldMap> & map, Context & context, LineInfo * at ) {
+    int nparam = sqlite3_bind_parameter_count(stmt);
+    for ( int p=1; p<=nparam; ++p ) {
+        const char * name = sqlite3_bind_parameter_name(stmt, p);
+        VarInfo * field = nullptr;
+        if ( name && (name[0]==':' || name[0]=='@' || name[0]=='$') ) {
+            field = sqlite_find_field(si, name + 1);
+        } else if ( uint32_t(p-1) < si->count ) {
+            field = si->fields[p-1];
+        }
+        if ( !field ) context.throw_error_at(at, "statement parameter %i has no matching field in %s", p, si->name);
+        sqlite_map_field(map, p, field, si, false, context, at);
+    }
+}
+
+static void sqlite_read_value ( sqlite3_stmt * stmt, int col, Type type, char * dst, Context & context, LineInfo * at ) {
+    switch ( type ) {
+    case Type::tBool:   *(bool *)dst = sqlite3_column_int(stmt, col)!=0; break;
+    case Type::tInt8:   *(int8_t *)dst = int8_t(sqlite3_column_int(stmt, col)); break;
+    case Type::tUInt8:  *(uint8_t *)dst = uint8_t(sqlite3_column_int(stmt, col)); break;
+    case Type::tInt16:  *(int16_t *)dst = int16_t(sqlite3_column_int(stmt, col)); break;
+    case Type::tUInt16: *(uint16_t *)dst = uint16_t(sqlite3_column_int(stmt, col)); break;
+    case Type::tInt:    *(int32_t *)dst = sqlite3_column_int(stmt, col); break;
+    case Type::tUInt:   *(uint32_t *)dst = uint32_t(sqlite3_column_int64(stmt, col)); break;
+    case Type::tInt64:  *(int64_t *)dst = sqlite3_column_int64(stmt, col); break;
+    case Type::tUInt64: *(uint64_t *)dst = uint64_t(sqlite3_column_int64(stmt, col)); break;
+    case Type::tFloat:  *(float *)dst = float(sqlite3_column_double(stmt, col)); break;
+    case Type::tDouble: *(double *)dst = sqlite3_column_double(stmt, col); break;
+    case Type::tString: {
+            auto text = (const char *) sqlite3_column_text(stmt, col);
+            *(char **)dst = text ? context.allocateString(text, uint32_t(sqlite3_column_bytes(stmt, col)), at) : nullptr;
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+static int sqlite_bind_value ( sqlite3_stmt * stmt, int param, Type type, const char * src ) {
+    switch ( type ) {
+    case Type::tBool:   return sqlite3_bind_int(stmt, param, *(const bool *)src ? 1 : 0);
+    case Type::tInt8:   return sqlite3_bind_int(stmt, param, *(const int8_t *)src);
+    case Type::tUInt8:  return sqlite3_bind_int(stmt, param, *(const uint8_t *)src);
+    case Type::tInt16:  return sqlite3_bind_int(stmt, param, *(const int16_t *)src);
+    case Type::tUInt16: return sqlite3_bind_int(stmt, param, *(const uint16_t *)src);
+    case Type::tInt:    return sqlite3_bind_int(stmt, param, *(const int32_t *)src);
+    case Type::tUInt:   return sqlite3_bind_int64(stmt, param, *(const uint32_t *)src);
+    case Type::tInt64:  return sqlite3_bind_int64(stmt, param, *(const int64_t *)src);
+    case Type::tUInt64: return sqlite3_bind_int64(stmt, param, sqlite3_int64(*(const uint64_t *)src));
+    case Type::tFloat:  return sqlite3_bind_double(stmt, param, *(const float *)src);
+    case Type::tDouble: return sqlite3_bind_double(stmt, param, *(const double *)src);
+    case Type::tString: {
+            // statement is stepped before the next row is bound, so the string does not need to be copied
+            auto text = *(const char * const *)src;
+            return sqlite3_bind_text(stmt, param, text ? text : "", -1, SQLITE_STATIC);
+        }
+    default:
+        return SQLITE_MISUSE;
+    }
+}
+
+static StructInfo * sqlite_array_struct ( TypeInfo * ti, const char * fname, Context & context, LineInfo * at ) {
+    if ( ti->type!=Type::tArray || !ti->firstType || ti->firstType->type!=Type::tStructure ) {
+        context.throw_error_at(at, "%s expects array of structures", fname);
+    }
+    return ti->firstType->structType;
+}
+
+// fields which can be copied as is take the default value from the prototype, everything else starts zeroed
+static void sqlite_init_row ( char * row, const char * proto, StructInfo * si ) {
+    memset(row, 0, si->size);
+    for ( uint32_t i=0; i!=si->count; ++i ) {
+        auto field = si->fields[i];
+        if ( (field->flags & TypeInfo::flag_isPod) || field->type==Type::tString ) {
+            memcpy(row + field->offset, proto + field->offset, getTypeSize(field));
+        }
+    }
+}
+
+vec4f sqlite3_fetch_rows ( Context & context, SimNode_CallBase * call, vec4f * args ) {
+    auto stmt = cast<sqlite3_stmt *>::to(args[0]);
+    if ( !stmt ) context.throw_error_at(&call->debugInfo, "sqlite3_fetch: statement is null");
+    auto si = sqlite_array_struct(call->types[1], "sqlite3_fetch", context, &call->debugInfo);
+    auto arr = cast<Array *>::to(args[1]);
+    auto proto = cast<char *>::to(args[2]);
+    if ( call->types[2]->type!=Type::tStructure || call->types[2]->structType!=si ) {
+        context.throw_error_at(&call->debugInfo, "sqlite3_fetch: prototype is not %s", si->name);
+    }
+    vector<SqliteFieldMap> map;
+    sqlite_map_columns(stmt, si, false, map, context, &call->debugInfo);
+    int rc;
+    while ( (rc = sqlite3_step(stmt))==SQLITE_ROW ) {
+        array_grow(context, *arr, si->size, &call->debugInfo);
+        char * row = arr->data + uint64_t(arr->size - 1) * si->size;
+        sqlite_init_row(row, proto, si);
+        for ( auto & fm : map ) {
+            sqlite_read_value(stmt, fm.column, fm.type, row + fm.offset, context, &call->debugInfo);
+        }
+    }
+    return cast<int32_t>::from(rc);
+}
+
+vec4f sqlite3_fetch_columns ( Context & context, SimNode_CallBase * call, vec4f * args ) {
+    auto stmt = cast<sqlite3_stmt *>::to(args[0]);
+    if ( !stmt ) context.throw_error_at(&call->debugInfo, "sqlite3_fetch_columns: statement is null");
+    auto ti = call->types[1];
+    if ( ti->type!=Type::tStructure ) context.throw_error_at(&call->debugInfo, "sqlite3_fetch_columns expects structure of arrays");
+    auto si = ti->structType;
+    auto columns = cast<char *>::to(args[1]);
+    vector<SqliteFieldMap> map;
+    sqlite_map_columns(stmt, si, true, map, context, &call->debugInfo);
+    int rc;
+    while ( (rc = sqlite3_step(stmt))==SQLITE_ROW ) {
+        for ( auto & fm : map ) {
+            auto & arr = *(Array *)(columns + fm.offset);
+            array_grow(context, arr, fm.stride, &call->debugInfo);
+            char * dst = arr.data + uint64_t(arr.size - 1) * fm.stride;
+            memset(dst, 0, fm.stride);
+            sqlite_read_value(stmt, fm.column, fm.type, dst, context, &call->debugInfo);
+        }
+    }
+    return cast<int32_t>::from(rc);
+}
+
+static int sqlite_insert_rows ( sqlite3_stmt * stmt, StructInfo * si, Array * arr, Context & context, LineInfo * at ) {
+    vector<SqliteFieldMap> map;
+    sqlite_map_parameters(stmt, si, map, context, at);
+    // whole array is inserted in one transaction, unless there is one already
+    sqlite3 * db = sqlite3_db_handle(stmt);
+    bool ownTransaction = sqlite3_get_autocommit(db)!=0;
+    if ( ownTransaction ) {
+        int rc = sqlite3_exec(db, "BEGIN", nullptr, nullptr, nullptr);
+        if ( rc!=SQLITE_OK ) return rc;
+    }
+    int rc = SQLITE_DONE;
+    for ( uint32_t i=0; i!=arr->size && rc==SQLITE_DONE; ++i ) {
+        const char * row = arr->data + uint64_t(i) * si->size;
+        for ( auto & fm : map ) {
+            rc = sqlite_bind_value(stmt, fm.column, fm.type, row + fm.offset);
+            if ( rc!=SQLITE_OK ) break;
+        }
+        if ( rc==SQLITE_OK ) rc = sqlite3_step(stmt);
+        sqlite3_reset(stmt);
+    }
+    sqlite3_clear_bindings(stmt);
+    if ( ownTransaction ) {
+        sqlite3_exec(db, rc==SQLITE_DONE ? "COMMIT" : "ROLLBACK", nullptr, nullptr, nullptr);
+    }
+    return rc;
+}
+
+vec4f sqlite3_insert_rows ( Context & context, SimNode_CallBase * call, vec4f * args ) {
+    auto stmt = cast<sqlite3_stmt *>::to(args[0]);
+    if ( !stmt ) context.throw_error_at(&call->debugInfo, "sqlite3_insert: statement is null");
+    auto si = sqlite_array_struct(call->types[1], "sqlite3_insert", context, &call->debugInfo);
+    auto arr = cast<Array *>::to(args[1]);
+    return cast<int32_t>::from(sqlite_insert_rows(stmt, si, arr, context, &call->debugInfo));
+}
+
+// identifiers go into the SQL text as "name", with embedded quotes doubled
+static void sqlite_write_identifier ( TextWriter & sql, const char * name ) {
+    sql << '"';
+    for ( const char * ch = name; *ch; ++ch ) {
+        if ( *ch=='"' ) sql << '"';
+        sql << *ch;
+    }
+    sql << '"';
+}
+
+// INSERT INTO "table" ("fields") VALUES (:fields)
+// with the cache, statement is prepared once and kept there until the text changes, otherwise it is prepared for this call only
+vec4f sqlite3_insert_table ( Context & context, SimNode_CallBase * call, vec4f * args ) {
+    auto db = cast<sqlite3 *>::to(args[0]);
+    if ( !db ) context.throw_error_at(&call->debugInfo, "sqlite3_insert: database is null");
+    auto table = cast<const char *>::to(args[1]);
+    if ( !table ) context.throw_error_at(&call->debugInfo, "sqlite3_insert: table name is empty");
+    auto si = sqlite_array_struct(call->types[2], "sqlite3_insert", context, &call->debugInfo);
+    auto arr = cast<Array *>::to(args[2]);
+    auto cache = call->nArguments>3 ? cast<sqlite3_stmt **>::to(args[3]) : nullptr;
+    TextWriter sql;
+    sql << "INSERT INTO ";
+    sqlite_write_identifier(sql, table);
+    sql << " (";
+    for ( uint32_t i=0; i!=si->count; ++i ) {
+        if ( i ) sql << ",";
+        sqlite_write_identifier(sql, si->fields[i]->name);
+    }
+    sql << ") VALUES (";
+    for ( uint32_t i=0; i!=si->count; ++i ) sql << (i ? ",:" : ":") << si->fields[i]->name;
+    sql << ")";
+    auto sqlText = sql.str();
+    sqlite3_stmt * stmt = nullptr;
+    if ( cache && *cache ) {
+        auto cachedText = sqlite3_sql(*cache);
+        if ( sqlite3_db_handle(*cache)==db && cachedText && sqlText==cachedText ) {
+            stmt = *cache;
+        } else {
+            sqlite3_finalize(*cache);
+            *cache = nullptr;
+        }
+    }
+    if ( !stmt ) {
+        int rc = sqlite3_prepare_v3(db, sqlText.c_str(), -1, cache ? SQLITE_PREPARE_PERSISTENT : 0, &stmt, nullptr);
+        if ( rc!=SQLITE_OK ) return cast<int32_t>::from(rc);
+        if ( cache ) *cache = stmt;
+    }
+    // field which can't be bound panics, and the statement of this call should not leak
+    int rc = SQLITE_DONE;
+    bool ok = context.runWithCatch([&](){
+        rc = sqlite_insert_rows(stmt, si, arr, context, &call->debugInfo);
+    });
+    if ( !cache ) sqlite3_finalize(stmt);
+    if ( !ok ) context.throw_error_at(&call->debugInfo, "%s", context.getException());
+    return cast<int32_t>::from(rc);
+}
+
 void Module_dasSQLITE::initMain() {
 
     addExtern<DAS_BIND_FUN(sqlite3_exec)>(*this,lib,"sqlite3_exec",
@@ -83,6 +361,21 @@ void Module_dasSQLITE::initMain() {
     addExtern<DAS_BIND_FUN(sqlite3_bind_text_)>(*this,lib,"sqlite3_bind_text",
         SideEffects::worstDefault, "sqlite3_bind_text_")
             ->args({"stmt","index","data"});
+    addInterop<sqlite3_fetch_rows,int32_t,sqlite3_stmt *,vec4f,vec4f>(*this,lib,"_builtin_sqlite3_fetch_rows",
+        SideEffects::worstDefault, "sqlite3_fetch_rows")
+            ->args({"stmt","rows","prototype"});
+    addInterop<sqlite3_fetch_columns,int32_t,sqlite3_stmt *,vec4f>(*this,lib,"_builtin_sqlite3_fetch_columns",
+        SideEffects::worstDefault, "sqlite3_fetch_columns")
+            ->args({"stmt","columns"});
+    addInterop<sqlite3_insert_rows,int32_t,sqlite3_stmt *,vec4f>(*this,lib,"_builtin_sqlite3_insert_rows",
+        SideEffects::worstDefault, "sqlite3_insert_rows")
+            ->args({"stmt","rows"});
+    addInterop<sqlite3_insert_table,int32_t,sqlite3 *,const char *,vec4f>(*this,lib,"_builtin_sqlite3_insert_table",
+        SideEffects::worstDefault, "sqlite3_insert_table")
+            ->args({"db","table","rows"});
+    addInterop<sqlite3_insert_table,int32_t,sqlite3 *,const char *,vec4f,sqlite3_stmt **>(*this,lib,"_builtin_sqlite3_insert_table",
+        SideEffects::worstDefault, "sqlite3_insert_table")
+            ->args({"db","table","rows","cache"});
 
     for ( auto & pfn : this->functions.each() ) {
         // ok, lets fix up everything returning uint8? into returning string# and make it unsafe operation
@@ -2801,6 +2801,18 @@ namespace das {
         library.addModule(thisModule.get());
     }
 
+    Program::~Program() {
+        // contexts may outlive the program. what is still pending is dropped along with the AST, instead of paying for all of it now
+        for ( auto & wlazy : lazyDebugInfo ) {
+            if ( auto lazy = wlazy.lock() ) lazy->abandon();
+        }
+        // nodes are still alive at this point, arena goes away once the last of them is deleted
+        if ( nodeArena ) {
+            nodeArena->release();
+            nodeArena = nullptr;
+        }
+    }
+
     TypeDecl * Program::makeTypeDeclaration(const LineInfo &at, const string &name) {
 
         das::vector<das::StructurePtr> structs;
@@ -3012,6 +3024,8 @@ namespace das {
     }
 
     void Program::visitModule(Visitor & vis, Module * thatModule, bool visitGenerics) {
+        auto inputs = thatModule==thisModule.get() ? macroInputs : nullptr;
+        if ( inputs ) inputs->visitedProgram = true;
         vis.preVisitModule(thatModule);
         // enumerations
         thatModule->enumerations.foreach([&](auto & penum){
@@ -3027,6 +3041,7 @@ namespace das {
         thatModule->structures.foreach([&](auto & spst){
             Structure * pst = spst.get();
             if ( vis.canVisitStructure(pst) ) {
+                if ( inputs ) inputs->objects.insert(pst);
                 StructurePtr pstn = visitStructure(vis, pst);
                 if ( pstn.get() != pst ) {
                     thatModule->structures.replace(pst->name, pstn);
@@ -3052,6 +3067,7 @@ namespace das {
         vis.preVisitGlobalLetBody(this);
         thatModule->globals.foreach([&](auto & var){
             if ( vis.canVisitGlobalVariable(var.get()) ) {
+                if ( inputs ) inputs->objects.insert(var.get());
                 vis.preVisitGlobalLet(var);
                 if ( var->type ) {
                     vis.preVisit(var->type.get());
@@ -3088,6 +3104,7 @@ namespace das {
         thatModule->functions.foreach([&](auto & fn){
             if ( !fn->builtIn ) {
                 if ( vis.canVisitFunction(fn.get()) ) {
+                    if ( inputs ) inputs->objects.insert(fn.get());
                     auto nfn = fn->visit(vis);
                     if ( fn != nfn ) {
                         thatModule->functions.replace(fn->getMangledName(), nfn);
@@ -3610,6 +3610,8 @@ namespace das {
                     logs << "        gfun.mangledNameHash = MNH;\n";
                     logs << "        gfun.aotFunction = nullptr;\n";
                     logs << "        gfun.flags = 0;\n";
+                    logs << "        gfun.callCount = 0;\n";
+                    logs << "        gfun.loopCount = 0;\n";
                     logs << "        gfun.fastcall = " << pfun->fastCall << "/*pfun->fastCall*/;\n";
                     logs << "        gfun.unsafe = " << pfun->unsafeOperation << "/*pfun->unsafeOperation*/;\n";
                     logs << "        if ( " << (pfun->result->isRefType() && !pfun->result->ref)
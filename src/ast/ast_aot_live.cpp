@@ -0,0 +1,303 @@
+#include "daScript/misc/platform.h"
+
+#include "daScript/ast/ast_aot_live.h"
+#include "daScript/simulate/simulate_nodes.h"
+#include "daScript/misc/sysos.h"
+#include "daScript/misc/anyhash.h"
+
+#include <stdlib.h>
+#include <stdio.h>
+
+#if defined(_WIN32)
+#include <process.h>
+#define das_live_aot_getpid _getpid
+#else
+#include <unistd.h>
+#define das_live_aot_getpid getpid
+#endif
+
+namespace das {
+
+    typedef void (* LiveAotRegister) ( AotLibrary & );
+
+    static bool liveAotSaveFile ( const string & fname, const string & str ) {
+        FILE * f = fopen(fname.c_str(), "wb");
+        if ( !f ) return false;
+        size_t written = fwrite(str.c_str(), 1, str.length(), f);
+        fclose(f);
+        return written==str.length();
+    }
+
+    static bool liveAotFileExists ( const string & fname ) {
+        FILE * f = fopen(fname.c_str(), "rb");
+        if ( !f ) return false;
+        fclose(f);
+        return true;
+    }
+
+    #define DAS_LIVE_AOT_STR2(x) #x
+    #define DAS_LIVE_AOT_STR(x) DAS_LIVE_AOT_STR2(x)
+    #define DAS_LIVE_AOT_DEFINE(x) " -D" #x "=" DAS_LIVE_AOT_STR(x)
+
+    // configuration of this build of the runtime, as seen by the compiler. generated code must see the same headers
+    // the same way, otherwise node and context layouts won't match
+    static const char * liveAotBuildFlags =
+#if __cplusplus >= 202002L
+        " -std=c++20"
+#else
+        " -std=c++17"
+#endif
+#if !defined(__GXX_RTTI)
+        " -fno-rtti"
+#endif
+#if !defined(__cpp_exceptions)
+        " -fno-exceptions"
+#endif
+#if defined(__FMA__)
+        " -mfma"
+#endif
+#if defined(__AVX2__)
+        " -mavx2"
+#elif defined(__AVX__)
+        " -mavx"
+#endif
+#if defined(NDEBUG)
+        " -DNDEBUG=1"
+#endif
+        DAS_LIVE_AOT_DEFINE(DAS_FUSION)
+        DAS_LIVE_AOT_DEFINE(DAS_DEBUGGER)
+        DAS_LIVE_AOT_DEFINE(DAS_SMART_PTR_DEBUG)
+        DAS_LIVE_AOT_DEFINE(DAS_SMART_PTR_TRACKER)
+        DAS_LIVE_AOT_DEFINE(DAS_AST_ARENA)
+#if defined(DAS_ENABLE_EXCEPTIONS)
+        DAS_LIVE_AOT_DEFINE(DAS_ENABLE_EXCEPTIONS)
+#endif
+        // public defines of EASTL, fmt and uriparser targets
+        " -DEA_PRAGMA_ONCE_SUPPORTED -DEASTL_ASSERT_ENABLED=0 -DEA_HAVE_CPP11_CONTAINERS -DEA_HAVE_CPP11_ATOMIC"
+        " -DEA_HAVE_CPP11_CONDITION_VARIABLE -DEA_HAVE_CPP11_MUTEX -DEA_HAVE_CPP11_THREAD -DEA_HAVE_CPP11_FUTURE"
+        " -DEA_HAVE_CPP11_TYPE_TRAITS -DEA_HAVE_CPP11_TUPLES -DEA_HAVE_CPP11_REGEX -DEA_HAVE_CPP11_RANDOM"
+        " -DEA_HAVE_CPP11_CHRONO -DEA_HAVE_CPP11_SCOPED_ALLOCATOR -DEA_HAVE_CPP11_INITIALIZER_LIST"
+        " -DEA_HAVE_CPP11_SYSTEM_ERROR -DEA_HAVE_CPP11_TYPEINDEX -DEASTL_STD_ITERATOR_CATEGORY_ENABLED"
+        " -DEASTL_STD_TYPE_TRAITS_AVAILABLE -DEASTL_MOVE_SEMANTICS_ENABLED -DEASTL_VARIADIC_TEMPLATES_ENABLED"
+        " -DEASTL_VARIABLE_TEMPLATES_ENABLED -DEASTL_INLINE_VARIABLE_ENABLED -DEASTL_HAVE_CPP11_TYPE_TRAITS"
+        " -DEASTL_INLINE_NAMESPACES_ENABLED -DEASTL_ALLOCATOR_EXPLICIT_ENABLED -DEASTL_USER_DEFINED_ALLOCATOR"
+#if defined(EASTL_MIMALLOC_ENABLED)
+        DAS_LIVE_AOT_DEFINE(EASTL_MIMALLOC_ENABLED)
+#endif
+        " -DFMT_CONSTEVAL=constexpr -DFMT_USE_CONSTEXPR=1 -DFMT_EXCEPTIONS=0"
+        " -DURI_NO_UNICODE -DURI_STATIC_BUILD";
+
+    // libraries built against other runtime can't be linked, even if the program is the same.
+    // build hash is the hash of the host executable, which the library resolves the runtime from
+    static uint64_t liveAotBuildHash() {
+        static std::atomic<uint64_t> buildHash { 0 };
+        if ( uint64_t h = buildHash.load(std::memory_order_acquire) ) return h;
+        uint64_t h = hash_block64((const uint8_t *)liveAotBuildFlags, uint32_t(strlen(liveAotBuildFlags)));
+        h = (h ^ uint64_t(sizeof(Context)) ^ (uint64_t(sizeof(SimFunction)) << 32)) * 1099511628211ull;
+        auto exeName = getExecutableFileName();
+        if ( FILE * f = fopen(exeName.c_str(), "rb") ) {
+            vector<uint8_t> chunk(1024*1024);
+            while ( size_t n = fread(chunk.data(), 1, chunk.size(), f) ) {
+                h = (h ^ hash_block64(chunk.data(), uint32_t(n))) * 1099511628211ull;
+            }
+            fclose(f);
+        }
+        buildHash.store(h | 1, std::memory_order_release);
+        return h | 1;
+    }
+
+    static std::atomic<uint32_t> liveAotTmpIndex { 0 };
+
+    LiveAot::LiveAot ( const LiveAotOptions & opt ) : options(opt) {
+        state = std::make_shared<std::atomic<int32_t>>(idle);
+        if ( options.cacheDir.empty() ) options.cacheDir = ".";
+        if ( options.flags.empty() ) {
+            auto root = getDasRoot();
+            options.flags = string(liveAotBuildFlags+1);
+            for ( const char * dir : { "/include", "/xxHash", "/EASTL/include", "/EASTL/packages/EABase/include/Common",
+                    "/EASTL/packages/mimalloc/include", "/3rdparty/fmt/include", "/3rdparty/uriparser/include" } ) {
+                options.flags += string(" -I\"") + root + dir + "\"";
+            }
+        }
+    }
+
+    LiveAot::~LiveAot() {
+        if ( worker.joinable() ) worker.detach();
+    }
+
+    bool LiveAot::generate ( const ProgramPtr & program, Context & context, TextWriter & tw, TextWriter & logs ) {
+        if ( program->options.getBoolOption("no_aot", false) ) {
+            logs << "live aot: disabled due to options no_aot=true\n";
+            return false;
+        }
+        // same as daScript -aot, only library registers itself via exported function instead of the global AotListBase
+        tw << "#include \"daScript/misc/platform.h\"\n\n";
+        tw << "#include \"daScript/simulate/simulate.h\"\n";
+        tw << "#include \"daScript/simulate/aot.h\"\n";
+        tw << "#include \"daScript/simulate/aot_library.h\"\n";
+        tw << "\n";
+        bool noAotModule = false;
+        program->library.foreach([&](Module * mod) {
+            if ( mod->name!="" ) {
+                tw << " // require " << (mod->name=="$" ? "builtin" : mod->name) << "\n";
+                if ( mod->aotRequire(tw)==ModuleAotType::no_aot ) noAotModule = true;
+            }
+            return true;
+        }, "*");
+        if ( noAotModule ) {
+            logs << "live aot: disabled due to module requirements\n";
+            return false;
+        }
+        tw << "\n";
+        tw << "#if defined(__GNUC__) && !defined(__clang__)\n";
+        tw << "#pragma GCC diagnostic ignored \"-Wunused-parameter\"\n";
+        tw << "#pragma GCC diagnostic ignored \"-Wunused-variable\"\n";
+        tw << "#pragma GCC diagnostic ignored \"-Wunused-function\"\n";
+        tw << "#pragma GCC diagnostic ignored \"-Wwrite-strings\"\n";
+        tw << "#pragma GCC diagnostic ignored \"-Wreturn-local-addr\"\n";
+        tw << "#pragma GCC diagnostic ignored \"-Wignored-qualifiers\"\n";
+        tw << "#pragma GCC diagnostic ignored \"-Wsign-compare\"\n";
+        tw << "#pragma GCC diagnostic ignored \"-Wsubobject-linkage\"\n";
+        tw << "#endif\n";
+        tw << "#if defined(__clang__)\n";
+        tw << "#pragma clang diagnostic ignored \"-Wunused-parameter\"\n";
+        tw << "#pragma clang diagnostic ignored \"-Wwritable-strings\"\n";
+        tw << "#pragma clang diagnostic ignored \"-Wunused-variable\"\n";
+        tw << "#pragma clang diagnostic ignored \"-Wunused-but-set-variable\"\n";
+        tw << "#pragma clang diagnostic ignored \"-Wunsequenced\"\n";
+        tw << "#pragma clang diagnostic ignored \"-Wunused-function\"\n";
+        tw << "#endif\n";
+        tw << "\n";
+        tw << "namespace das {\n";
+        tw << "namespace " << program->thisNamespace << " {\n";
+        daScriptEnvironment::bound->g_Program = program;   // setting it for the AOT macros
+        program->aotCpp(context, tw);
+        daScriptEnvironment::bound->g_Program.reset();
+        tw << "\nstatic void registerAotFunctions ( AotLibrary & aotLib ) {\n";
+        program->registerAotCpp(tw, context, false);
+        tw << "\tresolveTypeInfoAnnotations();\n";
+        tw << "};\n";
+        tw << "}\n";
+        tw << "}\n\n";
+        tw << "#if defined(_MSC_VER)\n";
+        tw << "extern \"C\" __declspec(dllexport) void das_live_aot_register ( das::AotLibrary & aotLib ) {\n";
+        tw << "#else\n";
+        tw << "extern \"C\" __attribute__((visibility(\"default\"))) void das_live_aot_register ( das::AotLibrary & aotLib ) {\n";
+        tw << "#endif\n";
+        tw << "\tdas::" << program->thisNamespace << "::registerAotFunctions(aotLib);\n";
+        tw << "}\n";
+        return true;
+    }
+
+    string LiveAot::compileCommand() const {
+        // compile into temporary file first, so that the other process never loads half written library.
+        // rename is part of the command, so that the cache is complete even if we exit before the compiler
+        TextWriter tmp;
+        tmp << soPath << "." << int32_t(das_live_aot_getpid()) << "." << liveAotTmpIndex++ << ".tmp";
+        string tmpPath = tmp.str();
+        string cmd = options.compiler + " " + options.flags + " -o \"" + tmpPath + "\" \"" + cppPath + "\" > \"" + logPath + "\" 2>&1";
+#if defined(_WIN32)
+        return cmd + " && move /Y \"" + tmpPath + "\" \"" + soPath + "\" > nul || (del \"" + tmpPath + "\" 2> nul & exit 1)";
+#else
+        return "( " + cmd + " && mv -f \"" + tmpPath + "\" \"" + soPath + "\" ) || ( rm -f \"" + tmpPath + "\"; exit 1 )";
+#endif
+    }
+
+    bool LiveAot::load ( Context & context, TextWriter & logs ) {
+        auto library = loadDynamicLibrary(soPath.c_str());
+        if ( !library ) {
+            logs << "live aot: can't load " << soPath << "\n";
+            return false;
+        }
+        auto registerFn = (LiveAotRegister) getFunctionAddress(library, "das_live_aot_register");
+        if ( !registerFn ) {
+            logs << "live aot: " << soPath << " does not export das_live_aot_register\n";
+            closeLibrary(library);
+            return false;
+        }
+        registerFn(aotLib);
+        // same as Program::linkCppAot, only functions which are missing stay interpreted
+        int32_t linked = 0;
+        for ( int32_t fni=0, fnis=das::min(context.getTotalFunctions(), int32_t(functionHashes.size())); fni!=fnis; ++fni ) {
+            SimFunction * fn = context.getFunction(fni);
+            if ( !functionHashes[fni] || fn->aot || fn->jit ) continue;
+            auto it = aotLib.find(functionHashes[fni]);
+            if ( it==aotLib.end() ) continue;
+            fn->code = (it->second)(context);
+            fn->aot = true;
+            fn->aotFunction = ((SimNode_CallBase *)fn->code)->aotFunction;
+            linked ++;
+        }
+        logs << "live aot: " << linked << " functions linked from " << soPath << "\n";
+        return true;
+    }
+
+    bool LiveAot::start ( const ProgramPtr & program, Context & context, TextWriter & logs ) {
+        if ( *state!=idle ) return *state==done;
+        // semantic hash of every function, same as Program::aotCpp computes
+        functionHashes.clear();
+        functionHashes.resize(context.getTotalFunctions(), 0);
+        vector<Function *> functions;
+        for ( auto & pm : program->library.getModules() ) {
+            pm->functions.foreach([&](auto pfun){
+                if ( pfun->index<0 || !pfun->used || pfun->index>=context.getTotalFunctions() ) return;
+                pfun->hash = getFunctionHash(pfun.get(), context.getFunction(pfun->index)->code, &context);
+                functions.push_back(pfun.get());
+            });
+        }
+        uint64_t key = hash_block64((const uint8_t *)options.compiler.c_str(), options.compiler.size());
+        key ^= hash_block64((const uint8_t *)options.flags.c_str(), options.flags.size()) * 1099511628211ull;
+        key = (key ^ liveAotBuildHash()) * 1099511628211ull;
+        for ( auto pfun : functions ) {
+            pfun->aotHash = getFunctionAotHash(pfun);
+            if ( !pfun->noAot ) functionHashes[pfun->index] = pfun->aotHash;
+            key = (key ^ pfun->aotHash) * 1099511628211ull;
+        }
+        TextWriter name;
+        name << options.cacheDir << "/das_aot_" << HEX << key << DEC;
+        cppPath = name.str() + ".cpp";
+#if defined(_WIN32)
+        soPath = name.str() + ".dll";
+#else
+        soPath = name.str() + ".so";
+#endif
+        logPath = name.str() + ".log";
+        if ( liveAotFileExists(soPath) ) {
+            *state = load(context, logs) ? done : failed;
+            return *state==done;
+        }
+        TextWriter cpp;
+        if ( !generate(program, context, cpp, logs) ) {
+            *state = failed;
+            return false;
+        }
+        if ( !liveAotSaveFile(cppPath, cpp.str()) ) {
+            logs << "live aot: can't write " << cppPath << "\n";
+            *state = failed;
+            return false;
+        }
+        *state = compiling;
+        string cmd = compileCommand();
+        if ( options.background ) {
+            worker = std::thread([st = state, cmd](){
+                *st = system(cmd.c_str())==0 ? compiled : failed;
+            });
+            return false;
+        }
+        *state = system(cmd.c_str())==0 ? compiled : failed;
+        return poll(context, logs);
+    }
+
+    bool LiveAot::poll ( Context & context, TextWriter & logs ) {
+        int32_t st = *state;
+        if ( st==compiled ) {
+            if ( worker.joinable() ) worker.join();
+            *state = load(context, logs) ? done : failed;
+            return *state==done;
+        } else if ( st==failed && worker.joinable() ) {
+            worker.join();
+            logs << "live aot: failed to compile " << cppPath << ", see " << logPath << "\n";
+        }
+        return st==done;
+    }
+}
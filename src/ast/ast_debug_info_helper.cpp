@@ -4,6 +4,7 @@
 #include "daScript/ast/ast_expressions.h"
 #include "daScript/ast/ast_visitor.h"
 #include "daScript/simulate/hash.h"
+#include "daScript/misc/performance_time.h"
 
 namespace das {
 
@@ -28,10 +29,53 @@ namespace das {
         tw << "\tVarInfo " << (int(vmn2v.size()*sizeof(VarInfo))) << " = " << int(vmn2v.size()) << " x " << int(sizeof(VarInfo)) << "\n";
         tw << "\tFuncInfo " << (int(fmn2f.size()*sizeof(FuncInfo))) << " = " << int(fmn2f.size()) << " x " << int(sizeof(FuncInfo)) << "\n";
         tw << "\tEnumInfo " << (int(emn2e.size()*sizeof(EnumInfo))) << " = " << int(emn2e.size()) << " x " << int(sizeof(EnumInfo)) << "\n";
+        tw << "\tTYPES " << int(th2t.size()) << " unique of " << int(typeLookups) << " lookups\n";
         tw << "\tSTRINGS " << debugInfo->stringBytes << "\n";
         tw << "TOTAL " << debugInfo->bytesAllocated() << "\n";
     }
 
+    LazyDebugInfoHelper::LazyDebugInfoHelper ( const shared_ptr<DebugInfoAllocator> & di )
+        : DebugInfoHelper(di) {
+    }
+
+    void LazyDebugInfoHelper::defer ( FuncInfo * info, const ExpressionPtr & body, const FunctionPtr & func ) {
+        lock_guard<mutex> guard(lock);
+        pending[info] = make_pair(body, func);
+        totalDeferred ++;
+        totalPending.store(pending.size(), std::memory_order_release);
+    }
+
+    void LazyDebugInfoHelper::materialize ( FuncInfo * info ) {
+        if ( !totalPending.load(std::memory_order_acquire) ) return;
+        // the other thread waits for the lock, and never sees half appended info
+        lock_guard<mutex> guard(lock);
+        auto it = pending.find(info);
+        if ( it==pending.end() ) return;
+        auto t0 = ref_time_ticks();
+        auto bytes0 = debugInfo->bytesAllocated();
+        if ( it->second.first ) appendLocalVariables(info, it->second.first);
+        if ( it->second.second ) appendGlobalVariables(info, it->second.second);
+        materializedBytes += debugInfo->bytesAllocated() - bytes0;
+        materializeNsec += get_time_nsec(t0);
+        totalMaterialized ++;
+        pending.erase(it);
+        totalPending.store(pending.size(), std::memory_order_release);
+    }
+
+    void LazyDebugInfoHelper::abandon () {
+        lock_guard<mutex> guard(lock);
+        totalAbandoned += pending.size();
+        pending.clear();
+        totalPending.store(0, std::memory_order_release);
+    }
+
+    void LazyDebugInfoHelper::logMemInfo ( TextWriter & tw ) {
+        lock_guard<mutex> guard(lock);
+        tw << "\tlazy debug info: " << totalMaterialized << " of " << totalDeferred << " functions and blocks materialized, "
+            << materializedBytes << " bytes, " << materializeNsec / 1000 << " usec, "
+            << totalAbandoned << " dropped with the program\n";
+    }
+
     void DebugInfoHelper::appendGlobalVariables ( FuncInfo * info, const FunctionPtr & body ) {
         info->globalCount = uint32_t(body->useGlobalVariables.size());
         info->globals = (VarInfo **) debugInfo->allocate(sizeof(VarInfo *) * info->globalCount);
@@ -194,12 +238,18 @@ namespace das {
     }
 
     TypeInfo * DebugInfoHelper::makeTypeInfo ( TypeInfo * info, const TypeDeclPtr & type ) {
+        // mangled name is built in place and hashed, string is only made for the new entries
+        // caller owned info is not cached, and its type may still change between calls
+        FixedBufferTextWriter mangledName;
+        type->getMangledName(mangledName);
+        uint64_t hash = hash_block64((const uint8_t *)mangledName.c_data(), mangledName.length());
         if ( info==nullptr ) {
-            string mangledName = type->getMangledName();
-            auto it = tmn2t.find(mangledName);
-            if ( it!=tmn2t.end() ) return it->second;
+            typeLookups ++;
+            auto it = th2t.find(hash);
+            if ( it!=th2t.end() ) return it->second;
             info = debugInfo->makeNode<TypeInfo>();
-            tmn2t[mangledName] = info;
+            th2t[hash] = info;
+            tmn2t[mangledName.str()] = info;
         }
         info->type = type->baseType;
         info->dimSize = (uint32_t) type->dim.size();
@@ -287,9 +337,8 @@ namespace das {
                 info->argNames[i] = debugInfo->allocateCachedName(type->argNames[i]);
             }
         }
-        auto mangledName = type->getMangledName();
         info->size = type->isAutoOrAlias() ? 0 : type->getSizeOf();
-        info->hash = hash_blockz64((uint8_t *)mangledName.c_str());
+        info->hash = hash;
         debugInfo->lookup[info->hash] = info;
         return info;
     }
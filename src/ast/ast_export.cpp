@@ -111,6 +111,9 @@ namespace das {
             auto functions = das::move(mod.functions);
             auto globals = das::move(mod.globals);
             mod.functionsByName.clear();
+            for ( auto & fn : functions.each() ) {
+                if ( !fn->used ) Module::touchFunctionGeneration(hash64z(fn->name.c_str()));
+            }
             // mod.globals.clear();
             for ( auto & fn : functions.each() ) {
                 if ( fn->used ) {
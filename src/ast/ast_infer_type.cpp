@@ -9,6 +9,8 @@
 
 namespace das {
 
+    extern "C" int64_t ref_time_ticks ();
+
     // in ast_handle of all places, due to reporting fields
     void reportTrait ( const TypeDeclPtr & type, const string & prefix, const callable<void(const TypeDeclPtr &, const string &)> & report );
 
@@ -59,6 +61,24 @@ namespace das {
         }
         bool finished() const { return !needRestart; }
         bool verbose = true;
+        bool useOverloadCache = true;
+    protected:
+        // node stamps (see Program::inferTypes). stamp is node identity of the function or the global variable, as of this pass
+        void * stampOwner = nullptr;
+        uint64_t stamp = 0;
+        void startStamp ( void * owner ) {
+            if ( !program->collectMacroStamps ) return;
+            stampOwner = owner;
+            stamp = 14695981039346656037ull;
+        }
+        void mixStamp ( const void * ptr ) {
+            stamp = (stamp ^ uint64_t(intptr_t(ptr))) * 1099511628211ull;
+        }
+        void finishStamp() {
+            if ( !stampOwner ) return;
+            program->macroStamps[stampOwner] = stamp;
+            stampOwner = nullptr;
+        }
     protected:
         FunctionPtr             func;
         VariablePtr             globalVar;
@@ -129,10 +149,12 @@ namespace das {
         }
         void reportAstChanged() {
             needRestart = true;
+            if ( program->trackMacroDirty ) program->markMacroDirty(func ? (void *)func.get() : (void *)globalVar.get());
         }
         virtual void reportFolding() override {
             FoldingVisitor::reportFolding();
             needRestart = true;
+            if ( program->trackMacroDirty ) program->markMacroDirty(func ? (void *)func.get() : (void *)globalVar.get());
         }
         string describeType ( const TypeDeclPtr & decl ) const {
             return verbose ? decl->describe() : "";
@@ -1143,6 +1165,46 @@ namespace das {
             return result;
         }
 
+        // overload cache key is the name, mangled name hashes of the argument types, and everything which affects visibility.
+        // entry keeps the key words, so collision of the combined hash is a miss and not the wrong overload
+        bool getOverloadCacheKey ( const string & name, const vector<TypeDeclPtr> & types, Module * inWhichModule, uint64_t kind, OverloadCacheKey & key ) const {
+            if ( !useOverloadCache || types.size() > DAS_MAX_FUNCTION_ARGUMENTS ) return false;
+            key.clear();
+            key.push_back(kind);
+            key.push_back(uint64_t(program->library.getModules().size()) | (uint64_t(Module::requireGeneration()) << 32));
+            key.push_back(uint64_t(intptr_t(inWhichModule)));
+            key.push_back(uint64_t(intptr_t(program->thisModule.get())));
+            key.push_back(( func && func->fromGeneric ) ? uint64_t(intptr_t(func->getOrigin()->module)) : 0);
+            key.push_back(hash_block64((const uint8_t *)name.c_str(), uint32_t(name.length())));
+            for ( auto & argT : types ) {
+                if ( !argT || argT->isAutoOrAlias() ) return false;
+                FixedBufferTextWriter mangledName;
+                argT->getMangledName(mangledName, true);
+                key.push_back(hash_block64((const uint8_t *)mangledName.c_data(), uint32_t(mangledName.length())));
+            }
+            uint64_t hash = 14695981039346656037ull;
+            for ( auto k : key ) hash = (hash ^ k) * 1099511628211ull;
+            key.hash = hash;
+            return true;
+        }
+
+        const MatchingFunctions * findCachedOverloads ( const OverloadCacheKey & cacheKey, uint64_t hFuncName ) const {
+            auto it = program->overloadCache.find(cacheKey.hash);
+            if ( it==program->overloadCache.end() || it->second.generation!=Module::functionGeneration(hFuncName) || it->second.key!=cacheKey ) {
+                program->overloadCacheMisses ++;
+                return nullptr;
+            }
+            program->overloadCacheHits ++;
+            return &it->second.functions;
+        }
+
+        void cacheOverloads ( const OverloadCacheKey & cacheKey, uint64_t hFuncName, const MatchingFunctions & result ) const {
+            auto & entry = program->overloadCache[cacheKey.hash];
+            entry.key = cacheKey;
+            entry.functions = result;
+            entry.generation = Module::functionGeneration(hFuncName);
+        }
+
         MatchingFunctions findMatchingFunctions ( const string & name, const vector<TypeDeclPtr> & types, bool inferBlock = false, bool visCheck = true ) const {
             string moduleName, funcName;
             splitTypeName(name, moduleName, funcName);
@@ -1150,6 +1212,11 @@ namespace das {
             auto inWhichModule = getSearchModule(moduleName);
             auto thisModule = program->thisModule.get();
             auto hFuncName = hash64z(funcName.c_str());
+            OverloadCacheKey cacheKey;
+            bool useCache = getOverloadCacheKey(name, types, inWhichModule, (inferBlock ? 1 : 0) | (visCheck ? 2 : 0), cacheKey);
+            if ( useCache ) {
+                if ( auto cached = findCachedOverloads(cacheKey, hFuncName) ) return *cached;
+            }
             program->library.foreach([&](Module * mod) -> bool {
                 auto itFnList = mod->functionsByName.find(hFuncName);
                 if ( itFnList != mod->functionsByName.end() ) {
@@ -1169,6 +1236,7 @@ namespace das {
                 }
                 return true;
             },moduleName);
+            if ( useCache ) cacheOverloads(cacheKey, hFuncName, result);
             return result;
         }
 
@@ -1206,6 +1274,11 @@ namespace das {
             auto inWhichModule = getSearchModule(moduleName);
             auto thisModule = program->thisModule.get();
             auto hFuncName = hash64z(funcName.c_str());
+            OverloadCacheKey cacheKey;
+            bool useCache = getOverloadCacheKey(name, types, inWhichModule, 4, cacheKey);
+            if ( useCache ) {
+                if ( auto cached = findCachedOverloads(cacheKey, hFuncName) ) return *cached;
+            }
             program->library.foreach([&](Module * mod) -> bool {
                 auto itFnList = mod->genericsByName.find(hFuncName);
                 if ( itFnList != mod->genericsByName.end() ) {
@@ -1222,6 +1295,7 @@ namespace das {
                 }
                 return true;
             },moduleName);
+            if ( useCache ) cacheOverloads(cacheKey, hFuncName, result);
             return result;
         }
 
@@ -1871,6 +1945,14 @@ namespace das {
             }
         }
         virtual StructurePtr visit ( Structure * var ) override {
+            startStamp(var);
+            if ( stampOwner ) {
+                for ( auto & fd : var->fields ) {
+                    mixStamp(fd.type.get());
+                    mixStamp(fd.init.get());
+                }
+                finishStamp();
+            }
             if ( !var->genCtor && var->hasAnyInitializers() ) {
                 if ( tryMakeStructureCtor(var, var->privateStructure) ) {
                     var->genCtor = true;
@@ -1888,6 +1970,11 @@ namespace das {
     // globals
         virtual void preVisitGlobalLet ( const VariablePtr & var ) override {
             Visitor::preVisitGlobalLet(var);
+            startStamp(var.get());
+            if ( stampOwner ) {
+                mixStamp(var->type.get());
+                mixStamp(var->init.get());
+            }
             if ( checkNoGlobalVariablesAtAll && !var->generated ) {
                 error("global variables are disabled by option no_global_variables_at_all", "", "",
                       var->at, CompilationError::no_global_variables );
@@ -1974,6 +2061,7 @@ namespace das {
             return Visitor::visitGlobalLetInit(var, init);
         }
         virtual VariablePtr visitGlobalLet ( const VariablePtr & var ) override {
+            finishStamp();
             if ( var->type && var->type->isExprType() ) {
                 return Visitor::visitGlobalLet(var);
             }
@@ -2020,6 +2108,11 @@ namespace das {
         }
         virtual void preVisit ( Function * f ) override {
             Visitor::preVisit(f);
+            startStamp(f);
+            if ( stampOwner ) {
+                mixStamp(f->result.get());
+                for ( auto & arg : f->arguments ) mixStamp(arg.get());
+            }
             canFoldResult = true;
             unsafeDepth = 0;
             func = f;
@@ -2148,11 +2241,13 @@ namespace das {
             DAS_ASSERT(with.size()==0);
             labels.clear();
             func.reset();
+            finishStamp();
             return Visitor::visit(that);
         }
     // any expression
         virtual void preVisitExpression ( Expression * expr ) override {
             Visitor::preVisitExpression(expr);
+            if ( stampOwner ) mixStamp(expr);
             expr->type.reset();
         }
     // const
@@ -8915,57 +9010,239 @@ namespace das {
         }
     };
 
+    void Program::markMacroDirty ( void * obj ) {
+        if ( obj ) {
+            macroDirty.insert(obj);
+        } else {
+            macroDirtyAll = true;
+        }
+    }
+
+    // changes when functions, generics, structures, globals, enumerations, or aliases of this module are added, removed, or replaced,
+    // and when enumeration entries are added or removed. macro inputs don't track these, so every macro is rerun
+    uint64_t Program::getMacroShapeStamp() const {
+        uint64_t stamp = 0;
+        thisModule->functions.foreach([&](auto & fn){ stamp ^= hash_uint64(uint64_t(intptr_t(fn.get()))); });
+        thisModule->generics.foreach([&](auto & fn){ stamp ^= hash_uint64(uint64_t(intptr_t(fn.get()))); });
+        thisModule->structures.foreach([&](auto & st){ stamp ^= hash_uint64(uint64_t(intptr_t(st.get()))); });
+        thisModule->globals.foreach([&](auto & var){ stamp ^= hash_uint64(uint64_t(intptr_t(var.get()))); });
+        thisModule->enumerations.foreach([&](auto & en){ stamp ^= hash_uint64(uint64_t(intptr_t(en.get())) + en->list.size()); });
+        thisModule->aliasTypes.foreach([&](auto & td){ stamp ^= hash_uint64(uint64_t(intptr_t(td.get())) ^ 0x5bd1e995); });
+        return stamp;
+    }
+
+    struct InferMacroWork {
+        Module *        mod = nullptr;
+        PassMacro *     macro = nullptr;
+        MacroInputs     inputs;
+        PassMacroTiming timing;
+        bool            pending = true;
+        bool            visible = true;
+        bool            ran = false;
+    };
+
     // try infer, if failed - no macros
-    // run macros til any of them does work, then reinfer and restart (i.e. infer after each macro)
+    // macros are kept in the work list. macro, which did work, changed what it was handed (see MacroInputs), or new nodes somewhere.
+    // pending macros, which were not handed any of it during their previous run, run before we reinfer, otherwise we reinfer first.
+    // after reinfer, what changed is what macros were handed, and whatever has different node stamp (see InferTypes::startStamp).
+    // only macros, which were handed something that changed, become pending again.
+    // builtin module macros run til nothing is pending, then we relocate uninitialized variables, then library macros.
+    // 'options macro_worklist=false' reruns every macro and reinfers after each one which did work
     void Program::inferTypes(TextWriter &logs, ModuleGroup & libGroup) {
         newLambdaIndex = 1;
+        const bool worklist = options.getBoolOption("macro_worklist", true);
+        macroStamps.clear();
+        collectMacroStamps = worklist;
         inferTypesDirty(logs, false);
-        bool anyMacrosDidWork = false;
         bool anyMacrosFailedToInfer = false;
-        if ( failed() ) goto failed_to_infer;
-        do {
-            anyMacrosDidWork = false;
-            anyMacrosFailedToInfer = false;
-            auto modMacro = [&](Module * mod) -> bool {    // we run all macros for each module
-                if ( thisModule->isVisibleDirectly(mod) && mod!=thisModule.get() ) {
+        if ( !failed() ) {
+            vector<InferMacroWork> builtinWork, libWork;
+            auto collectWork = [&]( vector<InferMacroWork> & work ) {
+                return [&](Module * mod) -> bool {
                     for ( const auto & pm : mod->macros ) {
-                        bool anyWork = pm->apply(this, thisModule.get());
-                        if ( failed() ) {                       // if macro failed, we report it, and we are done
-                            error("macro '" + mod->name + "::" + pm->name + "' failed", "", "", LineInfo());
-                            return false;
-                        }
-                        if ( anyWork ) {                        // if macro did anything, we done
-                            reportingInferErrors = true;
-                            inferTypesDirty(logs, true);
-                            reportingInferErrors = false;
-                            if ( failed() ) {                   // if it failed to infer types after, we report it
-                                error("macro '" + mod->name + "::" + pm->name + "' failed to infer", "", "", LineInfo());
-                                anyMacrosFailedToInfer = true;
-                                return false;
+                        InferMacroWork w;
+                        w.mod = mod;
+                        w.macro = pm.get();
+                        work.push_back(das::move(w));
+                    }
+                    return true;
+                };
+            };
+            Module::foreach(collectWork(builtinWork));
+            libGroup.foreach(collectWork(libWork), "*");
+            auto shapeStamp = getMacroShapeStamp();
+            auto totalRequire = thisModule->requireModule.size();
+            // macros, which did work since the last reinfer, and what they changed
+            vector<InferMacroWork *> batch;
+            das_hash_set<void *> batchDirty;
+            bool batchDirtyAll = false;
+            das_hash_map<void *,uint64_t> prevStamps;
+            auto batchTouched = [&]( const MacroInputs & inputs ) {
+                if ( batchDirtyAll ) return true;
+                for ( auto obj : batchDirty ) {
+                    if ( inputs.objects.find(obj)!=inputs.objects.end() ) return true;
+                }
+                return false;
+            };
+            auto invalidateWork = [&]( vector<InferMacroWork> & work, bool shapeChanged, bool requireChanged ) {
+                for ( auto & w : work ) {
+                    if ( w.pending ) continue;
+                    if ( !w.visible ) {
+                        w.pending = requireChanged;
+                    } else if ( !worklist || shapeChanged || macroDirtyAll || !w.inputs.visitedProgram ) {
+                        w.pending = true;
+                    } else {
+                        for ( auto obj : macroDirty ) {
+                            if ( w.inputs.objects.find(obj)!=w.inputs.objects.end() ) {
+                                w.pending = true;
+                                break;
                             }
-                            anyMacrosDidWork = true;            // if any work been done, we start over
-                            return false;
                         }
+                        if ( !w.pending ) w.timing.skipped ++;
                     }
                 }
-                return true;
             };
-            Module::foreach(modMacro);
-            if (failed()) break;
-            if (anyMacrosDidWork) continue;
-            if (relocatePotentiallyUninitialized(logs)) {
-                anyMacrosDidWork = true;
+            auto reinfer = [&]() -> bool {
+                if ( batch.empty() ) return true;
+                macroDirty = das::move(batchDirty);
+                macroDirtyAll = batchDirtyAll;
+                batchDirty.clear();
+                batchDirtyAll = false;
+                swap(prevStamps, macroStamps);
+                trackMacroDirty = true;
                 reportingInferErrors = true;
+                auto timeI = ref_time_ticks();
                 inferTypesDirty(logs, true);
+                auto inferTicks = ref_time_ticks() - timeI;
                 reportingInferErrors = false;
-                if ( failed() ) {
-                    error("internal compiler error: variable relocation infer to fail", "", "", LineInfo());
+                trackMacroDirty = false;
+                for ( auto w : batch ) {
+                    w->timing.inferTicks += inferTicks / int64_t(batch.size());
+                }
+                if ( failed() ) {                       // if it failed to infer types after, we report it
+                    string names;
+                    for ( auto w : batch ) {
+                        names += (names.empty() ? "" : ", ") + w->mod->name + "::" + w->macro->name;
+                    }
+                    error("macro '" + names + "' failed to infer", "", "", LineInfo());
+                    anyMacrosFailedToInfer = true;
+                    return false;
+                }
+                batch.clear();
+                // what has different stamp after the reinfer was changed by macros, or by the inference
+                for ( auto & it : macroStamps ) {
+                    auto old = prevStamps.find(it.first);
+                    if ( old==prevStamps.end() || old->second!=it.second ) {
+                        macroDirty.insert(it.first);
+                    }
+                }
+                auto newShapeStamp = getMacroShapeStamp();
+                auto newTotalRequire = thisModule->requireModule.size();
+                bool shapeChanged = newShapeStamp != shapeStamp;
+                bool requireChanged = newTotalRequire != totalRequire;
+                shapeStamp = newShapeStamp;
+                totalRequire = newTotalRequire;
+                invalidateWork(builtinWork, shapeChanged, requireChanged);
+                invalidateWork(libWork, shapeChanged, requireChanged);
+                macroDirty.clear();
+                macroDirtyAll = false;
+                return true;
+            };
+            auto runMacro = [&]( InferMacroWork & w, bool & didWork ) -> bool {
+                w.pending = false;
+                w.visible = thisModule->isVisibleDirectly(w.mod) && w.mod!=thisModule.get();
+                if ( !w.visible ) return true;
+                if ( !batch.empty() ) {
+                    // macro runs before the reinfer only if it did not look at anything which changed during its previous run
+                    bool independent = worklist && w.ran && w.inputs.visitedProgram && !batchTouched(w.inputs)
+                        && getMacroShapeStamp()==shapeStamp && thisModule->requireModule.size()==totalRequire;
+                    if ( !independent ) {
+                        if ( !reinfer() ) return false;
+                        w.pending = false;
+                    }
+                }
+                bool inBatch = !batch.empty();
+                w.inputs.clear();
+                macroInputs = &w.inputs;
+                auto timeM = ref_time_ticks();
+                bool anyWork = w.macro->apply(this, thisModule.get());
+                w.timing.macroTicks += ref_time_ticks() - timeM;
+                w.timing.runs ++;
+                w.ran = true;
+                macroInputs = nullptr;
+                if ( failed() ) {                       // if macro failed, we report it, and we are done
+                    error("macro '" + w.mod->name + "::" + w.macro->name + "' failed", "", "", LineInfo());
+                    return false;
+                }
+                if ( inBatch && batchTouched(w.inputs) ) {
+                    w.pending = true;                   // it looked at what is not inferred yet, so it runs again after the reinfer
+                }
+                if ( anyWork ) {
+                    w.timing.works ++;
+                    w.pending = true;                   // it may have more work to do
+                    didWork = true;
+                    batch.push_back(&w);
+                    if ( w.inputs.visitedProgram ) {
+                        for ( auto obj : w.inputs.objects ) batchDirty.insert(obj);
+                    } else {
+                        batchDirtyAll = true;           // we don't know what it changed
+                    }
+                    if ( !worklist && !reinfer() ) return false;
                 }
-                continue;
+                return true;
+            };
+            auto runWork = [&]( vector<InferMacroWork> & work, bool & didWork ) -> bool {
+                for ( ;; ) {
+                    bool anyPending = false;
+                    for ( auto & w : work ) {
+                        if ( !w.pending ) continue;
+                        anyPending = true;
+                        if ( !runMacro(w, didWork) ) return false;
+                    }
+                    if ( !anyPending ) {
+                        if ( batch.empty() ) return true;
+                        if ( !reinfer() ) return false;
+                    }
+                }
+            };
+            for ( ;; ) {
+                bool didWork = false;
+                if ( !runWork(builtinWork, didWork) ) break;
+                if ( relocatePotentiallyUninitialized(logs) ) {
+                    reportingInferErrors = true;
+                    inferTypesDirty(logs, true);
+                    reportingInferErrors = false;
+                    if ( failed() ) {
+                        error("internal compiler error: variable relocation infer to fail", "", "", LineInfo());
+                        break;
+                    }
+                    for ( auto & w : builtinWork ) w.pending = true;
+                    for ( auto & w : libWork ) w.pending = true;
+                    shapeStamp = getMacroShapeStamp();
+                    totalRequire = thisModule->requireModule.size();
+                    continue;
+                }
+                if ( !runWork(libWork, didWork) ) break;
+                if ( !didWork ) break;
+            }
+            if ( auto env = daScriptEnvironment::bound ) {
+                auto accountTiming = [&]( const vector<InferMacroWork> & work ) {
+                    for ( const auto & w : work ) {
+                        if ( !w.timing.runs ) continue;
+                        auto & timing = env->passMacroTimes[w.mod->name + "::" + w.macro->name];
+                        timing.macroTicks += w.timing.macroTicks;
+                        timing.inferTicks += w.timing.inferTicks;
+                        timing.runs += w.timing.runs;
+                        timing.works += w.timing.works;
+                        timing.skipped += w.timing.skipped;
+                    }
+                };
+                accountTiming(builtinWork);
+                accountTiming(libWork);
             }
-            libGroup.foreach(modMacro, "*");
-        } while ( !failed() && anyMacrosDidWork );
-    failed_to_infer:;
+        }
+        collectMacroStamps = false;
+        macroStamps.clear();
         if ( failed() && !anyMacrosFailedToInfer && !macroException ) {
             reportingInferErrors = true;
             inferTypesDirty(logs, true);
@@ -8975,6 +9252,7 @@ namespace das {
 
     void Program::inferTypesDirty(TextWriter & logs, bool verbose) {
         const bool log = options.getBoolOption("log_infer_passes",false);
+        const bool useOverloadCache = options.getBoolOption("overload_cache",true);
         int pass = 0, maxPasses = 50;
         if (auto maxP = options.find("max_infer_passes", Type::tInt)) {
             maxPasses = maxP->iValue;
@@ -8982,12 +9260,17 @@ namespace das {
         if ( log ) {
             logs << "INITIAL CODE:\n" << *this;
         }
+        overloadCache.clear();      // macros could have changed anything between the calls
+        auto cacheHits0 = overloadCacheHits;
+        auto cacheMisses0 = overloadCacheMisses;
         for ( pass = 0; pass < maxPasses; ++pass ) {
             if ( macroException ) break;
             failToCompile = false;
             errors.clear();
+            if ( collectMacroStamps ) macroStamps.clear();     // stamps of the last pass
             InferTypes context(this);
             context.verbose = verbose || log;
+            context.useOverloadCache = useOverloadCache;
             visit(context);
             for ( auto efn : context.extraFunctions ) {
                 addFunction(efn);
@@ -9000,6 +9283,7 @@ namespace das {
                 }
             });
             for ( auto rfn : refreshFunctions ) {
+                Module::touchFunctionGeneration(hash64z(get<0>(rfn)->name.c_str()));
                 if ( !thisModule->functions.refresh_key(get<1>(rfn), get<2>(rfn)) ) {
                     error("internal compiler error: failed to refresh '" + get<0>(rfn)->getMangledName() + "'", "", "", get<0>(rfn)->at);
                     goto failedIt;
@@ -9016,6 +9300,7 @@ namespace das {
             };
             Module::foreach(modMacro);
             library.foreach(modMacro, "*");
+            if ( anyMacrosDidWork ) overloadCache.clear();
             if ( log ) {
                 logs << "PASS " << pass << ":\n" << *this;
                 sort(errors.begin(), errors.end());
@@ -9027,6 +9312,12 @@ namespace das {
             if ( context.finished() ) break;
         }
     failedIt:;
+        if ( log ) {
+            auto hits = overloadCacheHits - cacheHits0;
+            auto total = hits + overloadCacheMisses - cacheMisses0;
+            logs << "OVERLOAD CACHE: " << hits << " hits of " << total << " lookups ("
+                << (total ? int(hits * 100 / total) : 0) << "%)\n";
+        }
         if (pass == maxPasses) {
             error("type inference exceeded maximum allowed number of passes ("+to_string(maxPasses)+")\n"
                     "this is likely due to a loop in the type system", "", "",
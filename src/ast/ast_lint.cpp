@@ -782,6 +782,7 @@ namespace das {
         "string_heap_size_hint",        Type::tInt,
         "string_heap_size_limit",       Type::tInt,
         "gc",                           Type::tBool,
+        "heap_telemetry",               Type::tBool,
         "solid_context",                Type::tBool,    // we will not have AOT or patches
     // aot
         "no_aot",                       Type::tBool,
@@ -815,11 +816,14 @@ namespace das {
         "print_func_use",               Type::tBool,
     // rtti
         "rtti",                         Type::tBool,
+        "lazy_debug_info",              Type::tBool,
     // optimization
         "optimize",                     Type::tBool,
         "fusion",                       Type::tBool,
         "remove_unused_symbols",        Type::tBool,
         "no_fast_call",                 Type::tBool,
+        "overload_cache",               Type::tBool,
+        "macro_worklist",               Type::tBool,
     // language
         "always_export_initializer",    Type::tBool,
         "infer_time_folding",           Type::tBool,
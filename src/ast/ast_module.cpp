@@ -27,6 +27,29 @@ namespace das {
 
     DAS_THREAD_LOCAL unsigned ModuleKarma = 0;
 
+    #define DAS_FUNCTION_GENERATION_BUCKETS 1024
+
+    // generation is bucketed by name hash, so it never needs to be cleaned up
+    static DAS_THREAD_LOCAL uint32_t g_functionGeneration[DAS_FUNCTION_GENERATION_BUCKETS];
+
+    uint32_t Module::functionGeneration ( uint64_t nameHash ) {
+        return g_functionGeneration[nameHash & (DAS_FUNCTION_GENERATION_BUCKETS-1)];
+    }
+
+    void Module::touchFunctionGeneration ( uint64_t nameHash ) {
+        g_functionGeneration[nameHash & (DAS_FUNCTION_GENERATION_BUCKETS-1)] ++;
+    }
+
+    static DAS_THREAD_LOCAL uint32_t g_requireGeneration = 0;
+
+    uint32_t Module::requireGeneration () {
+        return g_requireGeneration;
+    }
+
+    void Module::touchRequireGeneration () {
+        g_requireGeneration ++;
+    }
+
     bool splitTypeName ( const string & name, string & moduleName, string & funcName ) {
         auto at = name.find("::");
         if ( at!=string::npos ) {
@@ -68,6 +91,7 @@ namespace das {
     // MODULE
 
     void Module::addDependency ( Module * mod, bool pub ) {
+        touchRequireGeneration();
         requireModule[mod] |= pub;
         for ( auto it : mod->requireModule ) {
             if ( it.second ) {
@@ -78,6 +102,7 @@ namespace das {
 
     void Module::addBuiltinDependency ( ModuleLibrary & lib, Module * m, bool pub ) {
         lib.addModule(m);
+        touchRequireGeneration();
         requireModule[m] = pub;
     }
 
@@ -462,7 +487,9 @@ namespace das {
             }
         }
         if ( functions.insert(mangledName, fn) ) {
-            functionsByName[hash64z(fn->name.c_str())].push_back(fn);
+            auto hFuncName = hash64z(fn->name.c_str());
+            functionsByName[hFuncName].push_back(fn);
+            touchFunctionGeneration(hFuncName);
             fn->module = this;
             return true;
         } else {
@@ -478,7 +505,9 @@ namespace das {
         auto mangledName = fn->getMangledName();
         fn->module = nullptr;
         if ( generics.insert(mangledName, fn) ) {
-            genericsByName[hash64z(fn->name.c_str())].push_back(fn);
+            auto hFuncName = hash64z(fn->name.c_str());
+            genericsByName[hFuncName].push_back(fn);
+            touchFunctionGeneration(hFuncName);
             fn->module = this;
             return true;
         } else {
@@ -579,6 +608,7 @@ namespace das {
             program->thisModule->functions.foreach([&](auto fn){
                 addFunction(fn);
             });
+            touchRequireGeneration();
             for (auto & rqm : program->thisModule->requireModule) {
                 if ( rqm.first != this ) {
                     requireModule[rqm.first] |= rqm.second;
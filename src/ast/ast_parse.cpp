@@ -300,6 +300,8 @@ namespace das {
     static DAS_THREAD_LOCAL int64_t totInfer = 0;
     static DAS_THREAD_LOCAL int64_t totOpt = 0;
     static DAS_THREAD_LOCAL int64_t totM = 0;
+    static DAS_THREAD_LOCAL uint64_t totOverloadHits = 0;
+    static DAS_THREAD_LOCAL uint64_t totOverloadMisses = 0;
 
     bool trySerializeProgramModule (
             ProgramPtr          & program,
@@ -367,6 +369,17 @@ namespace das {
         ProgramPtr program = make_smart<Program>();
         ReuseCacheGuard rcg;
         auto time0 = ref_time_ticks();
+#if DAS_AST_ARENA
+        if ( policies.ast_arena ) {
+            program->nodeArena = NodeArena::create();
+        }
+        NodeArenaGuard arenaGuard(program->nodeArena);
+#else
+        if ( policies.ast_arena ) {
+            program->error("ast_arena requires the runtime built with DAS_AST_ARENA=1", "", "", LineInfo(), CompilationError::invalid_option);
+            return program;
+        }
+#endif
 
         if ( trySerializeProgramModule(program, access, fileName, libGroup, logs) ) {
             return program;
@@ -435,6 +448,9 @@ namespace das {
             restartInfer: program->inferTypes(logs, libGroup);
             if ( policies.macro_context_collect ) libGroup.collectMacroContexts();
             totInfer += get_time_usec(timeI);
+            totOverloadHits += program->overloadCacheHits;
+            totOverloadMisses += program->overloadCacheMisses;
+            program->overloadCacheHits = program->overloadCacheMisses = 0;
             if ( !program->failed() ) {
                 program->buildAccessFlags(logs);    // this is used by the lint pass
                 if ( program->patchAnnotations() ) {
@@ -694,7 +710,10 @@ namespace das {
         totInfer = 0;
         totOpt = 0;
         totM = 0;
+        totOverloadHits = 0;
+        totOverloadMisses = 0;
         daScriptEnvironment::bound->macroTimeTicks = 0;
+        daScriptEnvironment::bound->passMacroTimes.clear();
         vector<ModuleInfo> req;
         vector<string> missing, circular, notAllowed;
         das_set<string> dependencies;
@@ -802,6 +821,31 @@ namespace das {
                      << "\tmacro    " << (ref_time_delta_to_usec(daScriptEnvironment::bound->macroTimeTicks)  / 1000000.) << "\n"
                      << "\tmacro mods " << (totM     / 1000000.) << "\n"
                 ;
+                if ( !daScriptEnvironment::bound->passMacroTimes.empty() ) {
+                    vector<pair<string,PassMacroTiming>> macroTimes;
+                    for ( const auto & mt : daScriptEnvironment::bound->passMacroTimes ) {
+                        macroTimes.push_back(mt);
+                    }
+                    sort(macroTimes.begin(), macroTimes.end(), [](const auto & a, const auto & b){
+                        return a.second.macroTicks + a.second.inferTicks > b.second.macroTicks + b.second.inferTicks;
+                    });
+                    logs << "\tinfer macros\n";
+                    for ( const auto & mt : macroTimes ) {
+                        logs << "\t\t" << mt.first << " " << (ref_time_delta_to_usec(mt.second.macroTicks) / 1000000.)
+                             << ", reinfer " << (ref_time_delta_to_usec(mt.second.inferTicks) / 1000000.)
+                             << ", " << mt.second.runs << " runs, " << mt.second.works << " did work, "
+                             << mt.second.skipped << " skipped\n";
+                    }
+                }
+                if ( auto totLookups = totOverloadHits + totOverloadMisses ) {
+                    logs << "\toverload cache " << totOverloadHits << " hits of " << totLookups << " lookups ("
+                         << int(totOverloadHits * 100 / totLookups) << "%)\n";
+                }
+                if ( res->nodeArena ) {
+                    logs << "\tast arena " << res->nodeArena->nodesAllocated() << " nodes ("
+                         << res->nodeArena->nodesReused() << " reused), "
+                         << res->nodeArena->bytesAllocated() << " of " << res->nodeArena->bytesReserved() << " bytes\n";
+                }
             }
             return res;
         } else {
@@ -1263,7 +1263,9 @@ namespace das
         auto blk = static_pointer_cast<ExprBlock>(block);
         uint32_t argSp = blk->stackTop;
         auto info = context.thisHelper->makeInvokeableTypeDebugInfo(blk->makeBlockType(),blk->at);
-        if ( context.thisProgram->getDebugger() || context.thisProgram->options.getBoolOption("gc",false) ) {
+        if ( context.lazyDebugInfo ) {
+            static_cast<LazyDebugInfoHelper *>(context.lazyDebugInfo.get())->defer(info, (Expression *)this, nullptr);
+        } else if ( context.thisProgram->getDebugger() || context.thisProgram->options.getBoolOption("gc",false) ) {
             context.thisHelper->appendLocalVariables(info, (Expression *)this);
         }
         return context.code->makeNode<SimNode_MakeBlock>(at,block->simulate(context),argSp,stackTop,info);
@@ -3095,13 +3097,25 @@ void Program::buildGMNLookup ( Context & context, TextWriter & logs ) {
         context.heap->setLimit ( options.getUInt64Option("heap_size_limit", policies.max_heap_allocated) );
         context.stringHeap->setInitialSize ( options.getIntOption("string_heap_size_hint", policies.string_heap_size_hint) );
         context.stringHeap->setLimit ( options.getUInt64Option("string_heap_size_limit", policies.max_string_heap_allocated) );
+        if ( options.getBoolOption("heap_telemetry", false) ) {
+            context.heap->setTelemetryEnabled(true);
+            context.stringHeap->setTelemetryEnabled(true);
+        }
         context.constStringHeap = make_shared<ConstStringAllocator>();
         if ( globalStringHeapSize ) {
             context.constStringHeap->setInitialSize(globalStringHeapSize);
         }
-        DebugInfoHelper helper(context.debugInfo);
+        // lazy helper stays with the context, to append variables to the function infos later
+        shared_ptr<LazyDebugInfoHelper> lazyHelper;
+        if ( options.getBoolOption("lazy_debug_info",false) ) {
+            lazyHelper = make_shared<LazyDebugInfoHelper>(context.debugInfo);
+            lazyDebugInfo.push_back(lazyHelper);
+        }
+        DebugInfoHelper localHelper(context.debugInfo);
+        DebugInfoHelper & helper = lazyHelper ? *lazyHelper : localHelper;
         helper.rtti = options.getBoolOption("rtti",policies.rtti);
         context.thisHelper = &helper;
+        context.lazyDebugInfo = lazyHelper;
         context.globalVariables = (GlobalVariable *) context.code->allocate( totalVariables*sizeof(GlobalVariable) );
         context.globalsSize = 0;
         context.sharedSize = 0;
@@ -3190,7 +3204,9 @@ void Program::buildGMNLookup ( Context & context, TextWriter & logs ) {
                     if ( folding ) {
                         gfun.debugInfo->flags &= ~ (FuncInfo::flag_init | FuncInfo::flag_shutdown);
                     }
-                    if ( debuggerOrGC ) {
+                    if ( lazyHelper ) {
+                        lazyHelper->defer(gfun.debugInfo, pfun->body, pfun);
+                    } else if ( debuggerOrGC ) {
                         helper.appendLocalVariables(gfun.debugInfo, pfun->body);
                         helper.appendGlobalVariables(gfun.debugInfo, pfun);
                     }
@@ -3198,6 +3214,8 @@ void Program::buildGMNLookup ( Context & context, TextWriter & logs ) {
                     gfun.mangledNameHash = MNH;
                     gfun.aotFunction = nullptr;
                     gfun.flags = 0;
+                    gfun.callCount = 0;
+                    gfun.loopCount = 0;
                     gfun.fastcall = pfun->fastCall;
                     gfun.unsafe = pfun->unsafeOperation;
                     if ( pfun->result->isRefType() && !pfun->result->ref ) {
@@ -3485,6 +3503,9 @@ void Program::buildGMNLookup ( Context & context, TextWriter & logs ) {
         context.announceCreation();
         if ( options.getBoolOption("log_debug_mem",false) ) {
             helper.logMemInfo(logs);
+            if ( lazyHelper ) {
+                logs << "\tDEFERRED " << int(lazyHelper->deferred()) << " functions and blocks\n";
+            }
         }
         if ( !options.getBoolOption("rtti",policies.rtti) ) {
             context.thisProgram = nullptr;
@@ -61,6 +61,13 @@ namespace das {
         return module->addTypeFunction(kwd, true);
     }
 
+    // what infer macro found by name or by enumerating the module is its input (see Program::inferTypes)
+    static void touchMacroInput ( Module * mod, void * obj ) {
+        if ( daScriptEnvironment::bound && daScriptEnvironment::bound->g_Program ) {
+            daScriptEnvironment::bound->g_Program->touchMacroInput(mod, obj);
+        }
+    }
+
     void forEachFunction ( Module * module, const char * name, const TBlock<void,FunctionPtr> & block, Context * context, LineInfoArg * lineInfo ) {
         if ( !module ) context->throw_error_at(lineInfo, "expecting module, not null");
         vec4f args[1];
@@ -68,6 +75,7 @@ namespace das {
             auto & fnbn = module->functions;
             context->invokeEx(block, args, nullptr, [&](SimNode * code){
                 fnbn.foreach([&](auto fnv){
+                    touchMacroInput(module, fnv.get());
                     args[0] = cast<FunctionPtr>::from(fnv);
                     code->eval(*context);
                 });
@@ -76,6 +84,7 @@ namespace das {
             auto & fnbn = module->functionsByName[hash64z(name)];
             context->invokeEx(block, args, nullptr, [&](SimNode * code){
                 for ( auto & nv : fnbn ) {
+                    touchMacroInput(module, nv.get());
                     args[0] = cast<FunctionPtr>::from(nv);
                     code->eval(*context);
                 }
@@ -90,6 +99,7 @@ namespace das {
             auto & fnbn = module->generics;
             context->invokeEx(block, args, nullptr, [&](SimNode * code){
                 fnbn.foreach([&](auto nvfn){
+                    touchMacroInput(module, nvfn.get());
                     args[0] = cast<FunctionPtr>::from(nvfn);
                     code->eval(*context);
                 });
@@ -98,6 +108,7 @@ namespace das {
             auto & fnbn = module->genericsByName[hash64z(name)];
             context->invokeEx(block, args, nullptr, [&](SimNode * code){
                 for ( auto & nv : fnbn ) {
+                    touchMacroInput(module, nv.get());
                     args[0] = cast<FunctionPtr>::from(nv);
                     code->eval(*context);
                 }
@@ -118,7 +129,9 @@ namespace das {
     }
 
     VariablePtr findModuleVariable ( Module * module, const char * name ) {
-        return name ? module->findVariable(name) : nullptr;
+        auto var = name ? module->findVariable(name) : nullptr;
+        if ( var ) touchMacroInput(module, var.get());
+        return var;
     }
 
     // variable lookup with all the rules
@@ -350,18 +363,21 @@ namespace das {
 
     void for_each_structure ( Module * mod, const TBlock<void,StructurePtr> & block, Context * context, LineInfoArg * at ) {
         mod->structures.foreach([&](auto pst){
+            touchMacroInput(mod, pst.get());
             das_invoke<void>::invoke<StructurePtr>(context,at,block,pst);
         });
     }
 
     void for_each_generic ( Module * mod, const TBlock<void,FunctionPtr> & block, Context * context, LineInfoArg * at ) {
         mod->generics.foreach([&](auto fn){
+            touchMacroInput(mod, fn.get());
             das_invoke<void>::invoke<FunctionPtr>(context,at,block,fn);
         });
     }
 
     void for_each_global ( Module * mod, const TBlock<void,VariablePtr> & block, Context * context, LineInfoArg * at ) {
         mod->globals.foreach([&](auto var){
+            touchMacroInput(mod, var.get());
             das_invoke<void>::invoke<VariablePtr>(context,at,block,var);
         });
     }
@@ -552,6 +568,7 @@ namespace das {
         if ( !prog ) context->throw_error_at(at, "expecting program");
         auto st = prog->findStructure(name);
         if ( st.size()!=1 ) return nullptr;
+        touchMacroInput(st.back()->module, st.back().get());
         return st.back().get();
     }
 
@@ -659,9 +676,11 @@ namespace das {
                 return false;
             }
             it->second = publ;
+            Module::touchRequireGeneration();
             return true;
         }
         module->requireModule[reqModule] = publ;
+        Module::touchRequireGeneration();
         return true;
     }
 
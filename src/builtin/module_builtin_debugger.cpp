@@ -5,6 +5,7 @@
 #include "daScript/ast/ast_policy_types.h"
 #include "daScript/ast/ast_handle.h"
 #include "daScript/simulate/aot_builtin_debugger.h"
+#include "daScript/simulate/alloc_profiler.h"
 #include "module_builtin_rtti.h"
 #include "daScript/misc/performance_time.h"
 #include "daScript/misc/sysos.h"
@@ -838,10 +839,10 @@ namespace debugapi {
                 intptr_t iblock = intptr_t(pp->block);
                 if ( iblock & 1 ) {
                     block = (Block *) (iblock & ~1);
-                    info = block->info;
+                    info = context.requireDebugInfo(block->info);
                     SP = context.stack.bottom() + block->stackOffset;
                 } else {
-                    info = pp->info;
+                    info = context.requireDebugInfo(pp->info);
                 }
             }
             walker->onBeforeCall(pp,SP);
@@ -1114,6 +1115,48 @@ namespace debugapi {
         ctx.instrumentAllocations = isInstrumenting;
     }
 
+    bool is_context_allocations_instrumented ( Context & ctx ) {
+        return ctx.instrumentAllocations;
+    }
+
+    void start_allocation_profiler ( Context & ctx, uint64_t sampleInterval, int32_t stackDepth ) {
+        // restarting keeps the state from before the first start
+        bool prevInstrumentAllocations = ctx.allocProfiler ? ctx.allocProfiler->prevInstrumentAllocations : ctx.instrumentAllocations;
+        if ( ctx.allocProfiler ) delete ctx.allocProfiler;
+        ctx.allocProfiler = new AllocationProfiler(sampleInterval, stackDepth);
+        ctx.allocProfiler->prevInstrumentAllocations = prevInstrumentAllocations;
+        ctx.instrumentAllocations = true;
+    }
+
+    void stop_allocation_profiler ( Context & ctx ) {
+        if ( ctx.allocProfiler ) {
+            ctx.instrumentAllocations = ctx.allocProfiler->prevInstrumentAllocations;
+            delete ctx.allocProfiler;
+            ctx.allocProfiler = nullptr;
+        }
+    }
+
+    int32_t allocation_profiler_snapshot ( Context & ctx, Context * context, LineInfoArg * at ) {
+        if ( !ctx.allocProfiler ) context->throw_error_at(at, "allocation profiler is not running");
+        return ctx.allocProfiler->takeSnapshot();
+    }
+
+    char * allocation_profiler_report ( Context & ctx, Context * context, LineInfoArg * at ) {
+        if ( !ctx.allocProfiler ) context->throw_error_at(at, "allocation profiler is not running");
+        TextWriter tw;
+        ctx.allocProfiler->reportJson(tw);
+        return context->allocateString(tw.str(), at);
+    }
+
+    char * allocation_profiler_diff ( Context & ctx, int32_t fromSnapshot, int32_t toSnapshot, Context * context, LineInfoArg * at ) {
+        if ( !ctx.allocProfiler ) context->throw_error_at(at, "allocation profiler is not running");
+        TextWriter tw;
+        if ( !ctx.allocProfiler->diffJson(tw, fromSnapshot, toSnapshot) ) {
+            context->throw_error_at(at, "invalid snapshot index %i or %i", fromSnapshot, toSnapshot);
+        }
+        return context->allocateString(tw.str(), at);
+    }
+
     void instrument_context ( Context & ctx, bool isInstrumenting, const TBlock<bool,LineInfo> & blk, Context * context, LineInfoArg * line ) {
         ctx.instrumentContextNode(blk, isInstrumenting, context, line);
     }
@@ -1255,6 +1298,24 @@ namespace debugapi {
             addExtern<DAS_BIND_FUN(instrument_context_allocations)>(*this, lib,  "instrument_context_allocations",
                 SideEffects::modifyExternal, "instrument_context_allocations")
                     ->args({"context","isInstrumenting"});
+            addExtern<DAS_BIND_FUN(is_context_allocations_instrumented)>(*this, lib,  "is_context_allocations_instrumented",
+                SideEffects::accessExternal, "is_context_allocations_instrumented")
+                    ->arg("context");
+            addExtern<DAS_BIND_FUN(start_allocation_profiler)>(*this, lib,  "start_allocation_profiler",
+                SideEffects::modifyExternal, "start_allocation_profiler")
+                    ->args({"context","sampleInterval","stackDepth"});
+            addExtern<DAS_BIND_FUN(stop_allocation_profiler)>(*this, lib,  "stop_allocation_profiler",
+                SideEffects::modifyExternal, "stop_allocation_profiler")
+                    ->arg("context");
+            addExtern<DAS_BIND_FUN(allocation_profiler_snapshot)>(*this, lib,  "allocation_profiler_snapshot",
+                SideEffects::modifyExternal, "allocation_profiler_snapshot")
+                    ->args({"context","context","line"});
+            addExtern<DAS_BIND_FUN(allocation_profiler_report)>(*this, lib,  "allocation_profiler_report",
+                SideEffects::modifyExternal, "allocation_profiler_report")
+                    ->args({"context","context","line"});
+            addExtern<DAS_BIND_FUN(allocation_profiler_diff)>(*this, lib,  "allocation_profiler_diff",
+                SideEffects::modifyExternal, "allocation_profiler_diff")
+                    ->args({"context","fromSnapshot","toSnapshot","context","line"});
             addExtern<DAS_BIND_FUN(instrument_context)>(*this, lib,  "instrument_node",
                 SideEffects::modifyExternal, "instrument_context")
                     ->args({"context","isInstrumenting","block","context","line"});
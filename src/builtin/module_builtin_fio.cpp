@@ -25,7 +25,7 @@ MAKE_TYPE_FACTORY(clock, das::Time)// use MAKE_TYPE_FACTORY out of namespace. So
     /* macro definitions extracted from /usr/include/bits/mman.h */
     #define MAP_SHARED  0x01        /* Share changes.  */
     #define MAP_PRIVATE 0x02        /* Changes are private.  */
-    void* mmap(void* start, size_t length, int prot, int flags, int fd, off_t offset);
+    void* mmap(void* start, size_t length, int prot, int flags, int fd, uint64_t offset);
     int munmap(void* start, size_t length);
     static int getchar_wrapper(void) { return getchar(); } // workaround for non-std callconv (fastcall, vectorcall...)
 #else
@@ -222,7 +222,11 @@ namespace das {
         struct stat st;
         int fd = fileno((FILE *)f);
         fstat(fd, &st);
+        if ( uint64_t(st.st_size) > UINT32_MAX ) {
+            context->throw_error_at(at, "can't map %llu bytes as array, use fmap_lines or fmap_records", (unsigned long long)st.st_size);
+        }
         void* data = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        if ( data==MAP_FAILED ) context->throw_error_at(at, "can't map file");
         Array arr;
         arr.data = (char *) data;
         arr.capacity = arr.size = uint32_t(st.st_size);
@@ -234,6 +238,142 @@ namespace das {
         munmap(data, st.st_size);
     }
 
+    // Streams lines, or records split into fields, to the block without allocating on the heap.
+    // Regular files are mapped window by window from the current position, so there is no size limit. Everything else is read via the read-ahead buffer.
+    // Each line is copied to the reusable buffer only to zero terminate it, so strings are valid only until the block returns.
+    // Block can panic, which is longjmp unless DAS_ENABLE_EXCEPTIONS, so scan runs under runWithCatch, and the scanner releases the window and the buffers after.
+    struct FileLineScanner {
+        enum : uint64_t { mapWindow = 64*1024*1024, mapAlign = 64*1024, readAhead = 1024*1024 };
+        Context *       context;
+        LineInfoArg *   at;
+        const Block &   block;
+        char            recordSeparator;
+        char            fieldSeparator;
+        bool            split;
+        vector<char>    line;
+        vector<char *>  fields;
+        vector<char>    buffer;
+        void *          window = nullptr;
+        size_t          windowSize = 0;
+        FileLineScanner ( Context * ctx, LineInfoArg * lat, const Block & blk, char rs, char fs, bool sp )
+            : context(ctx), at(lat), block(blk), recordSeparator(rs), fieldSeparator(fs), split(sp) {}
+        ~FileLineScanner () {
+            unmap();
+        }
+        void unmap () {
+            if ( window ) {
+                munmap(window, windowSize);
+                window = nullptr;
+                windowSize = 0;
+            }
+        }
+        void emit () {
+            if ( recordSeparator=='\n' && !line.empty() && line.back()=='\r' ) line.pop_back();
+            line.push_back(0);
+            vec4f args[1];
+            if ( split ) {
+                fields.clear();
+                char * fs = line.data();
+                fields.push_back(fs);
+                for ( char * fe = fs + line.size() - 1; fs!=fe; ++fs ) {
+                    if ( *fs==fieldSeparator ) {
+                        *fs = 0;
+                        fields.push_back(fs + 1);
+                    }
+                }
+                Array arr;
+                arr.data = (char *) fields.data();
+                arr.capacity = arr.size = uint32_t(fields.size());
+                arr.lock = 1;
+                arr.flags = 0;
+                args[0] = cast<Array *>::from(&arr);
+                context->invoke(block, args, nullptr, at);
+            } else {
+                args[0] = cast<char *>::from(line.data());
+                context->invoke(block, args, nullptr, at);
+            }
+            line.clear();
+        }
+        void feed ( const char * data, size_t size ) {
+            const char * de = data + size;
+            while ( data!=de ) {
+                auto eol = (const char *) memchr(data, recordSeparator, de - data);
+                if ( !eol ) {
+                    line.insert(line.end(), data, de);
+                    break;
+                }
+                line.insert(line.end(), data, eol);
+                emit();
+                data = eol + 1;
+            }
+        }
+        void finish () {
+            if ( !line.empty() ) emit();
+        }
+        void scan ( FILE * f ) {
+            int fd = fileno(f);
+#if _WIN32
+            struct _stat64 st;
+            bool regular = _fstat64(fd, &st)==0 && (st.st_mode & _S_IFMT)==_S_IFREG;
+            int64_t position = regular ? _ftelli64(f) : -1;
+#else
+            struct stat st;
+            bool regular = fstat(fd, &st)==0 && (st.st_mode & S_IFMT)==S_IFREG;
+            int64_t position = regular ? int64_t(ftello(f)) : -1;
+#endif
+            if ( position>=0 ) {
+                // windows start at the aligned offset, and the head of the first one is skipped
+                uint64_t total = uint64_t(st.st_size);
+                uint64_t start = uint64_t(position);
+                for ( uint64_t offset=start & ~uint64_t(mapAlign-1); offset<total; offset+=mapWindow ) {
+                    windowSize = size_t(das::min(uint64_t(mapWindow), total - offset));
+                    window = mmap(nullptr, windowSize, PROT_READ, MAP_SHARED, fd, offset);
+                    if ( window==MAP_FAILED ) {
+                        window = nullptr;
+                        context->throw_error_at(at, "can't map file at offset %llu", (unsigned long long)offset);
+                    }
+                    size_t skip = offset<start ? size_t(start - offset) : 0;
+                    feed((const char *)window + skip, windowSize - skip);
+                    unmap();
+                }
+                // file is left at the end, same as after reading it
+#if _WIN32
+                _fseeki64(f, 0, SEEK_END);
+#else
+                fseeko(f, 0, SEEK_END);
+#endif
+            } else {
+                buffer.resize(readAhead);
+                while ( size_t bytes = fread(buffer.data(), 1, buffer.size(), f) ) {
+                    feed(buffer.data(), bytes);
+                }
+            }
+            finish();
+        }
+    };
+
+    static void builtin_scan_file ( FILE * f, char recordSeparator, char fieldSeparator, bool split, const Block & blk, Context * context, LineInfoArg * at ) {
+        bool ok;
+        {
+            FileLineScanner scanner(context, at, blk, recordSeparator, fieldSeparator, split);
+            ok = context->runWithCatch([&](){
+                scanner.scan(f);
+            });
+        }
+        if ( !ok ) context->throw_error_at(at, "%s", context->getException());
+    }
+
+    void builtin_map_file_lines ( const FILE * f, const TBlock<void,TTemporary<char *>> & blk, Context * context, LineInfoArg * at ) {
+        if ( !f ) context->throw_error_at(at, "can't map NULL file");
+        builtin_scan_file((FILE *)f, '\n', 0, false, blk, context, at);
+    }
+
+    void builtin_map_file_records ( const FILE * f, int32_t recordSeparator, int32_t fieldSeparator,
+            const TBlock<void,TTemporary<TArray<char *>>> & blk, Context * context, LineInfoArg * at ) {
+        if ( !f ) context->throw_error_at(at, "can't map NULL file");
+        builtin_scan_file((FILE *)f, char(recordSeparator), char(fieldSeparator), true, blk, context, at);
+    }
+
     int64_t builtin_ftell ( const FILE * f, Context * context, LineInfoArg * at ) {
         if ( !f ) context->throw_error_at(at, "can't ftell NULL");
         return ftell((FILE *)f);
@@ -607,6 +747,12 @@ namespace das {
             addExtern<DAS_BIND_FUN(builtin_map_file)>(*this, lib, "fmap",
                 SideEffects::modifyExternal, "builtin_map_file")
                     ->args({"file","block","context","line"});
+            addExtern<DAS_BIND_FUN(builtin_map_file_lines)>(*this, lib, "fmap_lines",
+                SideEffects::modifyExternal, "builtin_map_file_lines")
+                    ->args({"file","block","context","line"});
+            addExtern<DAS_BIND_FUN(builtin_map_file_records)>(*this, lib, "fmap_records",
+                SideEffects::modifyExternal, "builtin_map_file_records")
+                    ->args({"file","record_separator","field_separator","block","context","line"});
             addExtern<DAS_BIND_FUN(builtin_fgets)>(*this, lib, "fgets",
                 SideEffects::modifyExternal, "builtin_fgets")
                     ->args({"file","context","line"});
@@ -709,15 +855,15 @@ REGISTER_MODULE_IN_NAMESPACE(Module_FIO,das);
 #define WIN32_LEAN_AND_MEAN
 #include <windows.h>
 
-void * mmap (void* start, size_t length, int /*prot*/, int /*flags*/, int fd, off_t offset) {
+void * mmap (void* start, size_t length, int /*prot*/, int /*flags*/, int fd, uint64_t offset) {
     HANDLE hmap;
     void* temp;
     size_t len;
-    struct stat st;
+    struct _stat64 st;
     uint64_t o = offset;
     uint32_t l = o & 0xFFFFFFFF;
     uint32_t h = (o >> 32) & 0xFFFFFFFF;
-    fstat(fd, &st);
+    _fstat64(fd, &st);
     len = (size_t)st.st_size;
     if ((length + offset) > len)
         length = len - offset;
@@ -8,9 +8,17 @@
 #include "daScript/misc/job_que.h"
 #include "module_builtin_rtti.h"
 
+#if !DAS_NO_FILEIO
+#include <sys/stat.h>
+#endif
+
 MAKE_TYPE_FACTORY(JobStatus, JobStatus)
 MAKE_TYPE_FACTORY(Channel, Channel)
+MAKE_TYPE_FACTORY(JobWakeList, JobWakeList)
 MAKE_TYPE_FACTORY(LockBox, LockBox)
+MAKE_TYPE_FACTORY(RcuBox, RcuBox)
+MAKE_TYPE_FACTORY(MessageArena, MessageArena)
+MAKE_TYPE_FACTORY(AsyncIo, AsyncIo)
 
 MAKE_TYPE_FACTORY(Atomic32, AtomicTT<int32_t>)
 MAKE_TYPE_FACTORY(Atomic64, AtomicTT<int64_t>)
@@ -58,8 +66,159 @@ namespace das {
         }
     }
 
+    RcuBox::RcuBox() {
+        for ( auto & slot : readers ) {
+            slot.active[0] = 0;
+            slot.active[1] = 0;
+        }
+        current = nullptr;
+        epoch = 0;
+    }
+
+    RcuBox::~RcuBox() {
+        // data itself belongs to the heap of the context, which published it
+        lock_guard<mutex> guard(mCompleteMutex);
+        delete current.exchange(nullptr);
+        for ( auto & rv : retiredVersions ) delete rv.first;
+        retiredVersions.clear();
+        for ( auto version : reclaimedVersions ) delete version;
+        reclaimedVersions.clear();
+    }
+
+    int RcuBox::readerSlot() {
+        // threads are spread over the slots in order of their first read, so that readers don't share cache lines
+        static atomic<uint32_t> g_nextSlot{0};
+        static thread_local int slot = int(g_nextSlot++ % numReaderSlots);
+        return slot;
+    }
+
+    struct RcuReadGuard {
+        RcuReadGuard ( atomic<int32_t> & a ) : active(a) { active++; }
+        ~RcuReadGuard () { active--; }
+        atomic<int32_t> & active;
+    };
+
+    void RcuBox::get ( const TBlock<void,void *> & blk, Context * context, LineInfoArg * at ) {
+        bool ok;
+        {
+            // reader leaves the epoch even if the block panics, otherwise reclamation stops for good.
+            // panic is not c++ exception (unless DAS_ENABLE_EXCEPTIONS), so it's caught here and rethrown after
+            RcuReadGuard guard(readers[readerSlot()].active[epoch.load() & 1]);
+            Feature * version = current.load();
+            ok = context->runWithCatch([&](){
+                das_invoke<void>::invoke<void *>(context, at, blk, version ? version->data : nullptr);
+            });
+        }
+        if ( !ok ) context->throw_error_at(at, "%s", context->getException() ? context->getException() : "unknown exception");
+    }
+
+    void RcuBox::publish ( Feature * version ) {
+        Feature * old = current.exchange(version);
+        if ( old ) {
+            retiredVersions.emplace_back(old, epoch.load());
+        }
+        reclaim();
+        mCond.notify_all();
+    }
+
+    void RcuBox::reclaim() {
+        // epoch advances only when nobody is reading in the epoch before the current one.
+        // version retired in epoch E can't be seen by anyone once the epoch is E+2
+        for ( int pass=0; pass!=2 && !retiredVersions.empty(); ++pass ) {
+            uint64_t e = epoch.load();
+            uint64_t parity = (e + 1) & 1;
+            for ( auto & slot : readers ) {
+                if ( slot.active[parity].load() ) return;
+            }
+            epoch.store(e + 1);
+        }
+        uint64_t e = epoch.load();
+        auto it = retiredVersions.begin();
+        while ( it != retiredVersions.end() ) {
+            if ( it->second + 2 <= e ) {
+                reclaimedVersions.push_back(it->first);
+                it = retiredVersions.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    void RcuBox::set ( void * data, TypeInfo * ti, Context * context ) {
+        lock_guard<mutex> guard(mCompleteMutex);
+        publish(new Feature(data,ti,context));
+    }
+
+    void RcuBox::update ( const TBlock<void *,void *> & blk, TypeInfo * ti, Context * context, LineInfoArg * at ) {
+        lock_guard<mutex> guard(mCompleteMutex);
+        Feature * version = current.load();
+        void * newData = das_invoke<void *>::invoke<void *>(context, at, blk, version ? version->data : nullptr);
+        if ( !version || newData != version->data ) {
+            publish(new Feature(newData,ti,context));
+        }
+    }
+
+    void RcuBox::collect ( const TBlock<void,void *> & blk, Context * context, LineInfoArg * at ) {
+        // only the context which published the data can delete it
+        vector<Feature *> own;
+        {
+            lock_guard<mutex> guard(mCompleteMutex);
+            reclaim();
+            auto it = reclaimedVersions.begin();
+            while ( it != reclaimedVersions.end() ) {
+                if ( (*it)->from.get() == context ) {
+                    own.push_back(*it);
+                    it = reclaimedVersions.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+        }
+        for ( auto version : own ) {
+            if ( version->data ) {
+                das_invoke<void>::invoke<void *>(context, at, blk, version->data);
+            }
+            delete version;
+        }
+    }
+
+    int32_t RcuBox::retired() {
+        lock_guard<mutex> guard(mCompleteMutex);
+        return int32_t(retiredVersions.size() + reclaimedVersions.size());
+    }
+
+    MessageArena::~MessageArena() {
+        for ( auto page : pages ) {
+            das_aligned_free16(page);
+        }
+        pageSize = 0;
+    }
+
+    char * MessageArena::allocate ( uint32_t size ) {
+        size = (size + 15) & ~15;
+        if ( pageOffset + size > pageCapacity ) {
+            pageCapacity = size > pageSize ? size : pageSize;
+            pages.push_back((char *) das_aligned_alloc16(pageCapacity));
+            pageOffset = 0;
+        }
+        char * data = pages.back() + pageOffset;
+        memset(data, 0, size);
+        pageOffset += size;
+        totalBytes += size;
+        return data;
+    }
+
+    char * MessageArena::allocateString ( const char * str, uint32_t len ) {
+        char * data = allocate(len + 1);
+        if ( len ) memcpy(data, str, len);
+        return data;
+    }
+
     Channel::~Channel() {
         lock_guard<mutex> guard(mCompleteMutex);
+        for ( auto & f : pipe ) {
+            if ( !f.type ) delete (MessageArena *) f.data;  // arena, which nobody adopted
+        }
         pipe = {};
         tail.clear();
         DAS_ASSERT(mRef==0);
@@ -69,6 +228,7 @@ namespace das {
         lock_guard<mutex> guard(mCompleteMutex);
         pipe.emplace_back(data, ti, context!=owner ? context : nullptr);
         mCond.notify_all();  // notify_one??
+        wakeWaiters();
     }
 
     void Channel::pushBatch ( void ** data, int count, TypeInfo * ti, Context * context ) {
@@ -78,9 +238,17 @@ namespace das {
             pipe.emplace_back(data[i], ti, pushCtx);
         }
         mCond.notify_all();  // notify_one??
+        wakeWaiters();
     }
 
-    void Channel::pop ( const TBlock<void,void *> & blk, Context * context, LineInfoArg * at ) {
+    void Channel::pushArena ( MessageArena * arena ) {
+        lock_guard<mutex> guard(mCompleteMutex);
+        pipe.emplace_back(arena, nullptr, nullptr);    // does not pin any context
+        mCond.notify_all();  // notify_one??
+        wakeWaiters();
+    }
+
+    void Channel::waitForItem() {
         while ( true ) {
             unique_lock<mutex> uguard(mCompleteMutex);
             if ( !mCond.wait_for(uguard, std::chrono::milliseconds(mSleepMs), [&]() {
@@ -92,14 +260,40 @@ namespace das {
                 break;
             }
         }
-        lock_guard<mutex> guard(mCompleteMutex);
-        if ( pipe.empty() ) {
-            tail.clear();
-        } else {
-            tail = das::move(pipe.front());
-            pipe.pop_front();
+    }
+
+    void Channel::pop ( const TBlock<void,void *> & blk, Context * context, LineInfoArg * at ) {
+        waitForItem();
+        {
+            lock_guard<mutex> guard(mCompleteMutex);
+            if ( pipe.empty() || pipe.front().type ) {
+                if ( pipe.empty() ) {
+                    tail.clear();
+                } else {
+                    tail = das::move(pipe.front());
+                    pipe.pop_front();
+                }
+                das_invoke<void>::invoke<void *>(context, at, blk, tail.data);
+                return;
+            }
+        }
+        // arena stays in the pipe. error is thrown without the lock, longjmp does not unwind the guard
+        context->throw_error_at(at, "channel pop: got message arena, use pop_arena or for_each_arena");
+    }
+
+    MessageArena * Channel::popArena ( Context * context, LineInfoArg * at ) {
+        waitForItem();
+        {
+            lock_guard<mutex> guard(mCompleteMutex);
+            if ( pipe.empty() ) return nullptr;
+            if ( !pipe.front().type ) {
+                auto arena = (MessageArena *) pipe.front().data;
+                pipe.pop_front();
+                return arena;
+            }
         }
-        das_invoke<void>::invoke<void *>(context, at, blk, tail.data);
+        context->throw_error_at(at, "popArena: expecting message arena, got regular message");
+        return nullptr;
     }
 
     bool Channel::isEmpty() const {
@@ -256,6 +450,12 @@ namespace das {
         }
     };
 
+    struct JobWakeListAnnotation : ManagedStructureAnnotation<JobWakeList,false> {
+        JobWakeListAnnotation(ModuleLibrary & ml) : ManagedStructureAnnotation ("JobWakeList", ml) {
+            addProperty<DAS_BIND_MANAGED_PROP(isEmpty)>("isEmpty");
+        }
+    };
+
     mutex              g_jobQueMutex;
     shared_ptr<JobQue> g_jobQue;
 
@@ -320,6 +520,158 @@ namespace das {
     };
 
 
+    RcuBox * rcuBoxCreate( Context *, LineInfoArg * ) {
+        RcuBox * box = new RcuBox();
+        box->addRef();
+        return box;
+    }
+
+    void rcuBoxRemove( RcuBox * & box, Context * context, LineInfoArg * at ) {
+        if (!box->isValid()) context->throw_error_at(at, "rcu box is invalid (already deleted?)");
+        if (box->releaseRef()) context->throw_error_at(at, "rcu box beeing deleted while being used");
+        delete box;
+        box = nullptr;
+    }
+
+    void withRcuBox ( const TBlock<void,RcuBox *> & blk, Context * context, LineInfoArg * at ) {
+        RcuBox box;
+        AddReleaseGuard<RcuBox> guard(&box, context, at);
+        das_invoke<void>::invoke<RcuBox *>(context, at, blk, &box);
+    }
+
+    vec4f rcuBoxSet ( Context & context, SimNode_CallBase * call, vec4f * args ) {
+        auto box = cast<RcuBox *>::to(args[0]);
+        if ( !box ) context.throw_error_at(call->debugInfo, "rcuBoxSet: box is null");
+        void * data = cast<void *>::to(args[1]);
+        TypeInfo * ti = call->types[1];
+        box->set(data, ti, &context);
+        return v_zero();
+    }
+
+    void rcuBoxUpdate ( RcuBox * box, TypeInfo * ti, const TBlock<void *,void*> & blk, Context * context, LineInfoArg * at ) {
+        if ( !box ) context->throw_error_at(at, "rcuBoxUpdate: box is null");
+        box->update(blk,ti,context,at);
+    }
+
+    void rcuBoxGet ( RcuBox * box, const TBlock<void,void*> & blk, Context * context, LineInfoArg * at ) {
+        if ( !box ) context->throw_error_at(at, "rcuBoxGet: box is null");
+        box->get(blk,context,at);
+    }
+
+    void rcuBoxCollect ( RcuBox * box, const TBlock<void,void*> & blk, Context * context, LineInfoArg * at ) {
+        if ( !box ) context->throw_error_at(at, "rcuBoxCollect: box is null");
+        box->collect(blk,context,at);
+    }
+
+    struct RcuBoxAnnotation : ManagedStructureAnnotation<RcuBox,false> {
+        RcuBoxAnnotation(ModuleLibrary & ml) : ManagedStructureAnnotation ("RcuBox", ml) {
+            addProperty<DAS_BIND_MANAGED_PROP(retired)>("retired");
+        }
+        virtual int32_t getGcFlags(das_set<Structure *> &, das_set<Annotation *> &) const override {
+            return TypeDecl::gcFlag_heap | TypeDecl::gcFlag_stringHeap;
+        }
+        virtual void walk(DataWalker & walker, void * data) override {
+            bool gResolve = daScriptEnvironment::bound->g_resolve_annotations;
+            daScriptEnvironment::bound->g_resolve_annotations = false;
+            BasicStructureAnnotation::walk(walker, data);
+            RcuBox * box = (RcuBox *) data;
+            if ( !box->isValid() ) {
+                walker.invalidData();
+            } else {
+                box->peek([&](void * data, TypeInfo * ti, Context *) {
+                    walker.walk((char *)&data, ti);
+                });
+            }
+            daScriptEnvironment::bound->g_resolve_annotations = gResolve;
+        }
+    };
+
+    MessageArena * messageArenaCreate ( int32_t pageSize, Context * context, LineInfoArg * at ) {
+        if ( pageSize < 0 ) context->throw_error_at(at, "messageArenaCreate: negative page size %i", pageSize);
+        return new MessageArena(uint32_t(pageSize));
+    }
+
+    void messageArenaRemove ( MessageArena * & arena, Context * context, LineInfoArg * at ) {
+        if ( !arena ) return;
+        if ( !arena->isValid() ) context->throw_error_at(at, "message arena is invalid (already deleted?)");
+        delete arena;
+        arena = nullptr;
+    }
+
+    void * messageArenaAlloc ( MessageArena * arena, int32_t size, Context * context, LineInfoArg * at ) {
+        if ( !arena ) context->throw_error_at(at, "messageArenaAlloc: arena is null");
+        if ( size < 0 ) context->throw_error_at(at, "messageArenaAlloc: negative size %i", size);
+        return arena->allocate(uint32_t(size));
+    }
+
+    char * messageArenaString ( MessageArena * arena, const char * str, Context * context, LineInfoArg * at ) {
+        if ( !arena ) context->throw_error_at(at, "messageArenaString: arena is null");
+        if ( !str ) return nullptr;
+        return arena->allocateString(str, uint32_t(strlen(str)));
+    }
+
+    vec4f messageArenaArray ( Context & context, SimNode_CallBase * call, vec4f * args ) {
+        auto arena = cast<MessageArena *>::to(args[0]);
+        if ( !arena ) context.throw_error_at(call->debugInfo, "messageArenaArray: arena is null");
+        Array * arr = cast<Array *>::to(args[1]);
+        int32_t count = cast<int32_t>::to(args[2]);
+        if ( count < 0 ) context.throw_error_at(call->debugInfo, "messageArenaArray: negative count %i", count);
+        if ( arr->data ) context.throw_error_at(call->debugInfo, "messageArenaArray: array is not empty");
+        TypeInfo * ti = call->types[1];
+        uint64_t bytes = uint64_t(getTypeSize(ti->firstType)) * uint64_t(count);
+        if ( bytes > 0x7fffffff ) context.throw_error_at(call->debugInfo, "messageArenaArray: %i elements is too big (%llu bytes)", count, (unsigned long long) bytes);
+        // arena owns the memory. array is shared, and stays locked, so that it can't be resized or deleted
+        arr->data = arena->allocate(uint32_t(bytes));
+        arr->size = arr->capacity = uint32_t(count);
+        arr->lock = 1;
+        arr->shared = true;
+        return v_zero();
+    }
+
+    void messageArenaPush ( MessageArena * arena, void * data, Context * context, LineInfoArg * at ) {
+        if ( !arena ) context->throw_error_at(at, "messageArenaPush: arena is null");
+        arena->roots.push_back(data);
+    }
+
+    void messageArenaForEach ( MessageArena * arena, const TBlock<void,void*> & blk, Context * context, LineInfoArg * at ) {
+        if ( !arena ) context->throw_error_at(at, "messageArenaForEach: arena is null");
+        for ( auto data : arena->roots ) {
+            das_invoke<void>::invoke<void *>(context, at, blk, data);
+        }
+    }
+
+    void messageArenaConsume ( MessageArena * & arena, const TBlock<void,void*> & blk, Context * context, LineInfoArg * at ) {
+        if ( !arena ) context->throw_error_at(at, "messageArenaConsume: arena is null");
+        // arena is released even if the block throws
+        bool ok = context->runWithCatch([&](){
+            for ( auto data : arena->roots ) {
+                das_invoke<void>::invoke<void *>(context, at, blk, data);
+            }
+        });
+        delete arena;
+        arena = nullptr;
+        if ( !ok ) context->throw_error_at(at, "%s", context->getException() ? context->getException() : "unknown exception");
+    }
+
+    void channelPushArena ( Channel * ch, MessageArena * & arena, Context * context, LineInfoArg * at ) {
+        if ( !ch ) context->throw_error_at(at, "channelPushArena: channel is null");
+        if ( !arena ) context->throw_error_at(at, "channelPushArena: arena is null");
+        ch->pushArena(arena);
+        arena = nullptr;    // ownership moves with the message
+    }
+
+    MessageArena * channelPopArena ( Channel * ch, Context * context, LineInfoArg * at ) {
+        if ( !ch ) context->throw_error_at(at, "channelPopArena: channel is null");
+        return ch->popArena(context, at);
+    }
+
+    struct MessageArenaAnnotation : ManagedStructureAnnotation<MessageArena,false> {
+        MessageArenaAnnotation(ModuleLibrary & ml) : ManagedStructureAnnotation ("MessageArena", ml) {
+            addProperty<DAS_BIND_MANAGED_PROP(bytes)>("bytes");
+            addProperty<DAS_BIND_MANAGED_PROP(messages)>("messages");
+        }
+    };
+
     template <typename TT>
     struct AtomicAnnotation : ManagedStructureAnnotation<AtomicTT<TT>,false> {
         AtomicAnnotation(const char * ttname, ModuleLibrary & ml) : ManagedStructureAnnotation<AtomicTT<TT>,false> (ttname, ml) {
@@ -338,6 +690,297 @@ namespace das {
             walker.walk(vd, &info);
         }
     };
+
+    AsyncIo::AsyncIo ( int32_t threads ) {
+        if ( threads <= 0 ) threads = 4;
+        auto bound = daScriptEnvironment::bound;
+        for ( int32_t t=0; t!=threads; ++t ) {
+            workers.emplace_back([this,bound]() {
+                daScriptEnvironment::bound = bound;
+                run();
+            });
+        }
+    }
+
+    AsyncIo::~AsyncIo() {
+        {
+            lock_guard<mutex> guard(requestLock);
+            stopping = true;
+        }
+        requestCond.notify_all();
+        for ( auto & w : workers ) w.join();
+        for ( auto & it : ready ) delete it.second;
+    }
+
+    int64_t AsyncIo::submit ( Op op, vector<string> && paths, vector<uint8_t> && data, Channel * channel ) {
+        int32_t count = int32_t(paths.size());
+        if ( !count ) return 0;
+        Request req;
+        req.op = op;
+        req.ticket = nextTicket.fetch_add(count);
+        req.paths = das::move(paths);
+        req.data = das::move(data);
+        req.channel = ChannelRef(channel);
+        {
+            lock_guard<mutex> guard(mCompleteMutex);
+            if ( channel ) {
+                pendingRouted += count;
+            } else {
+                pendingTickets += count;
+            }
+        }
+        auto ticket = req.ticket;
+        {
+            lock_guard<mutex> guard(requestLock);
+            requests.emplace_back(das::move(req));
+        }
+        requestCond.notify_one();
+        return ticket;
+    }
+
+    void AsyncIo::run() {
+        vector<Completion> res;
+        for (;;) {
+            Request req;
+            {
+                unique_lock<mutex> lock(requestLock);
+                requestCond.wait(lock, [&]() { return stopping || !requests.empty(); });
+                if ( requests.empty() ) return;     // stopping, but only once the queue is drained
+                req = das::move(requests.front());
+                requests.pop_front();
+            }
+            perform(req, res);
+            req.channel = ChannelRef();     // completions hold the channel now, request must not outlive the reader
+            // whole batch is completed at once, under one lock and one wakeup
+            {
+                lock_guard<mutex> guard(mCompleteMutex);
+                for ( auto & c : res ) {
+                    if ( c.channel.channel ) {
+                        pendingRouted --;
+                        routed.emplace_back(das::move(c));
+                    } else {
+                        pendingTickets --;
+                        ready[c.ticket] = new Completion(das::move(c));
+                    }
+                }
+            }
+            mCond.notify_all();
+            res.clear();
+        }
+    }
+
+    void AsyncIo::perform ( Request & req, vector<Completion> & res ) {
+        for ( size_t i=0, is=req.paths.size(); i!=is; ++i ) {
+            res.emplace_back();
+            auto & c = res.back();
+            c.ticket = req.ticket + int64_t(i);
+            c.channel = ChannelRef(req.channel.channel);
+#if !DAS_NO_FILEIO
+            const char * path = req.paths[i].c_str();
+            if ( req.op==Op::stat ) {
+                struct stat st;
+                if ( stat(path, &st)!=0 ) {
+                    c.error = errno;
+                } else {
+                    c.size = uint64_t(st.st_size);
+                    c.mtime = int64_t(st.st_mtime);
+                }
+            } else if ( req.op==Op::write ) {
+                FILE * f = fopen(path, "wb");
+                if ( !f ) {
+                    c.error = errno;
+                } else {
+                    c.size = fwrite(req.data.data(), 1, req.data.size(), f);
+                    if ( c.size!=req.data.size() ) c.error = errno ? errno : EIO;
+                    if ( fclose(f)!=0 && !c.error ) c.error = errno;
+                }
+            } else {
+                FILE * f = fopen(path, "rb");
+                if ( !f ) {
+                    c.error = errno;
+                } else {
+                    // size is only a hint, pipes and files which are being written to are read to the end
+                    struct stat st;
+                    size_t expected = fstat(fileno(f), &st)==0 ? size_t(st.st_size) : 0;
+                    c.data.resize(expected);
+                    size_t total = expected ? fread(c.data.data(), 1, expected, f) : 0;
+                    if ( total==expected ) {
+                        char buf[16384];
+                        while ( size_t bytes = fread(buf, 1, sizeof(buf), f) ) {
+                            c.data.insert(c.data.end(), buf, buf + bytes);
+                            total += bytes;
+                        }
+                    }
+                    c.data.resize(total);
+                    c.size = total;
+                    if ( ferror(f) ) c.error = EIO;
+                    fclose(f);
+                }
+            }
+#else
+            c.error = ENOSYS;
+#endif
+        }
+    }
+
+    bool AsyncIo::isDone ( int64_t ticket ) const {
+        lock_guard<mutex> guard(mCompleteMutex);
+        return ready.find(ticket)!=ready.end();
+    }
+
+    // blocks until the ticket is complete. returns false once nothing is pending, i.e. for taken or unknown tickets
+    bool AsyncIo::waitFor ( int64_t ticket ) {
+        unique_lock<mutex> lock(mCompleteMutex);
+        mCond.wait(lock, [&]() { return ready.find(ticket)!=ready.end() || pendingTickets==0; });
+        return ready.find(ticket)!=ready.end();
+    }
+
+    bool AsyncIo::take ( int64_t ticket, Completion & res ) {
+        Completion * c = nullptr;
+        {
+            lock_guard<mutex> guard(mCompleteMutex);
+            auto it = ready.find(ticket);
+            if ( it==ready.end() ) return false;
+            c = it->second;
+            ready.erase(it);
+        }
+        res = das::move(*c);
+        delete c;
+        return true;
+    }
+
+    void AsyncIo::dispatch ( bool wait, vector<Completion> & res ) {
+        unique_lock<mutex> lock(mCompleteMutex);
+        if ( wait ) {
+            mCond.wait(lock, [&]() { return !routed.empty() || pendingRouted==0; });
+        }
+        res.swap(routed);
+    }
+
+    int32_t AsyncIo::pending() const {
+        lock_guard<mutex> guard(mCompleteMutex);
+        return pendingTickets + pendingRouted;
+    }
+
+    struct AsyncIoAnnotation : ManagedStructureAnnotation<AsyncIo,false> {
+        AsyncIoAnnotation(ModuleLibrary & ml) : ManagedStructureAnnotation ("AsyncIo", ml) {
+            addProperty<DAS_BIND_MANAGED_PROP(pending)>("pending");
+        }
+    };
+
+    AsyncIo * asyncIoCreate ( int32_t threads, Context *, LineInfoArg * ) {
+        AsyncIo * io = new AsyncIo(threads);
+        io->addRef();
+        return io;
+    }
+
+    void asyncIoRemove ( AsyncIo * & io, Context * context, LineInfoArg * at ) {
+        if ( !io ) context->throw_error_at(at, "async io is null");
+        if (!io->isValid()) context->throw_error_at(at, "async io is invalid (already deleted?)");
+        if (io->releaseRef()) context->throw_error_at(at, "async io beeing deleted while being used");
+        delete io;
+        io = nullptr;
+    }
+
+    void withAsyncIo ( int32_t threads, const TBlock<void,AsyncIo *> & blk, Context * context, LineInfoArg * at ) {
+        // panic in the block longjmps over this frame, so the service is on the heap and is destroyed before the rethrow
+        AsyncIo * io = new AsyncIo(threads);
+        io->addRef();
+        bool ok = context->runWithCatch([&](){
+            das_invoke<void>::invoke<AsyncIo *>(context, at, blk, io);
+        });
+        int ref = io->releaseRef();
+        if ( !ref ) delete io;      // joins the workers, once they are done with the queued requests
+        if ( !ok ) context->throw_error_at(at, "%s", context->getException() ? context->getException() : "unknown exception");
+        if ( ref ) context->throw_error_at(at, "synch primitive deleted while being used (ref=%i)", ref);
+    }
+
+    static void verifyAsyncIo ( AsyncIo * io, Context * context, LineInfoArg * at ) {
+        if ( !io ) context->throw_error_at(at, "async io is null");
+        if ( !io->isValid() ) context->throw_error_at(at, "async io is invalid (already deleted?)");
+    }
+
+    int64_t asyncIoRead ( AsyncIo * io, const char * path, Channel * ch, Context * context, LineInfoArg * at ) {
+        verifyAsyncIo(io, context, at);
+        vector<string> paths = { path ? path : "" };
+        return io->submit(AsyncIo::Op::read, das::move(paths), {}, ch);
+    }
+
+    int64_t asyncIoReadBatch ( AsyncIo * io, const TArray<char *> & paths, Channel * ch, Context * context, LineInfoArg * at ) {
+        verifyAsyncIo(io, context, at);
+        vector<string> batch;
+        batch.reserve(paths.size);
+        for ( uint32_t i=0; i!=paths.size; ++i ) {
+            batch.emplace_back(paths[i] ? paths[i] : "");
+        }
+        return io->submit(AsyncIo::Op::read, das::move(batch), {}, ch);
+    }
+
+    int64_t asyncIoWrite ( AsyncIo * io, const char * path, const TArray<uint8_t> & data, Channel * ch, Context * context, LineInfoArg * at ) {
+        verifyAsyncIo(io, context, at);
+        vector<string> paths = { path ? path : "" };
+        vector<uint8_t> payload((uint8_t *)data.data, (uint8_t *)data.data + data.size);
+        return io->submit(AsyncIo::Op::write, das::move(paths), das::move(payload), ch);
+    }
+
+    int64_t asyncIoStat ( AsyncIo * io, const char * path, Channel * ch, Context * context, LineInfoArg * at ) {
+        verifyAsyncIo(io, context, at);
+        vector<string> paths = { path ? path : "" };
+        return io->submit(AsyncIo::Op::stat, das::move(paths), {}, ch);
+    }
+
+    bool asyncIoDone ( AsyncIo * io, int64_t ticket, Context * context, LineInfoArg * at ) {
+        verifyAsyncIo(io, context, at);
+        return io->isDone(ticket);
+    }
+
+    bool asyncIoJoin ( AsyncIo * io, int64_t ticket, Context * context, LineInfoArg * at ) {
+        verifyAsyncIo(io, context, at);
+        return io->waitFor(ticket);
+    }
+
+    // completion data is passed as the locked temporary array, which points to the C++ memory
+    static void asyncIoDataArray ( Array & arr, AsyncIo::Completion & c ) {
+        arr.data = (char *) c.data.data();
+        arr.capacity = arr.size = uint32_t(c.data.size());
+        arr.lock = 1;
+        arr.flags = 0;
+    }
+
+    bool asyncIoTake ( AsyncIo * io, int64_t ticket, const TBlock<void,int32_t,uint64_t,int64_t,TTemporary<TArray<uint8_t>>> & blk, Context * context, LineInfoArg * at ) {
+        verifyAsyncIo(io, context, at);
+        AsyncIo::Completion c;
+        if ( !io->take(ticket, c) ) return false;
+        Array arr;
+        asyncIoDataArray(arr, c);
+        vec4f args[4];
+        args[0] = cast<int32_t>::from(c.error);
+        args[1] = cast<uint64_t>::from(c.size);
+        args[2] = cast<int64_t>::from(c.mtime);
+        args[3] = cast<Array *>::from(&arr);
+        context->invoke(blk, args, nullptr, at);
+        return true;
+    }
+
+    int32_t asyncIoDispatch ( AsyncIo * io, bool wait,
+            const TBlock<void,int64_t,int32_t,uint64_t,int64_t,TTemporary<TArray<uint8_t>>,Channel *> & blk, Context * context, LineInfoArg * at ) {
+        verifyAsyncIo(io, context, at);
+        vector<AsyncIo::Completion> res;
+        io->dispatch(wait, res);
+        for ( auto & c : res ) {
+            Array arr;
+            asyncIoDataArray(arr, c);
+            vec4f args[6];
+            args[0] = cast<int64_t>::from(c.ticket);
+            args[1] = cast<int32_t>::from(c.error);
+            args[2] = cast<uint64_t>::from(c.size);
+            args[3] = cast<int64_t>::from(c.mtime);
+            args[4] = cast<Array *>::from(&arr);
+            args[5] = cast<Channel *>::from(c.channel.channel);
+            context->invoke(blk, args, nullptr, at);
+        }
+        return int32_t(res.size());
+    }
 }
 
 das::Context* get_clone_context( das::Context * ctx, uint32_t category );//link time resolved dependencies
@@ -364,6 +1007,111 @@ namespace das {
         }, 0, JobPriority::Default);
     }
 
+    // Clones for new_job_pooled. Clone is taken from the pool when job is pushed, and returned to it once job is done,
+    // with heaps reset and globals restored to the state right after the init script. Clone, which is still referenced
+    // by the data it pushed to channels or boxes, is not returned. If the init script allocated
+    // on the heap, snapshot of the globals is no good, and init script is rerun instead.
+    // Pool is keyed by the source context and its code, so that new context at the same address never gets stale clones.
+    // Pools are dropped along with the job que.
+    struct PooledJobContext {
+        shared_ptr<Context> context;
+        vector<char>        globals;
+        bool                snapshot = false;
+    };
+
+    struct JobContextPool {
+        Context *                   source = nullptr;
+        uint64_t                    codeId = 0;
+        vector<PooledJobContext>    free;
+    };
+
+    static mutex                                    g_jobPoolMutex;
+    static vector<JobContextPool>                   g_jobPools;     // by source context, there are only few of those
+    static uint64_t                                 g_jobPoolGeneration = 0;
+    static atomic<uint64_t>                         g_jobPoolReused{0};
+    static atomic<uint64_t>                         g_jobPoolPinned{0};
+
+    static PooledJobContext acquirePooledJobContext ( Context * context, uint64_t & generation ) {
+        {
+            lock_guard<mutex> guard(g_jobPoolMutex);
+            generation = g_jobPoolGeneration;
+            auto it = find_if(g_jobPools.begin(), g_jobPools.end(), [&](const JobContextPool & pool) {
+                return pool.source==context;
+            });
+            if ( it==g_jobPools.end() ) {
+                it = g_jobPools.emplace(g_jobPools.end());
+                it->source = context;
+            }
+            if ( it->codeId != context->getCodeAllocatorId() ) {
+                it->codeId = context->getCodeAllocatorId();
+                it->free.clear();
+            }
+            if ( !it->free.empty() ) {
+                PooledJobContext res = das::move(it->free.back());
+                it->free.pop_back();
+                g_jobPoolReused ++;
+                return res;
+            }
+        }
+        PooledJobContext res;
+        res.context.reset(get_clone_context(context, uint32_t(ContextCategory::job_clone)));
+        res.snapshot = res.context->snapshotGlobals(res.globals);
+        return res;
+    }
+
+    static void releasePooledJobContext ( Context * source, uint64_t codeId, uint64_t generation, PooledJobContext && pc ) {
+        // whatever job pushed to the channel or the box still lives on its heap, and pins the context.
+        // such clone can't be recycled, it's dropped once the last of that data is gone
+        if ( pc.context.use_count()!=1 ) {
+            g_jobPoolPinned ++;
+            return;
+        }
+        pc.context->recycle(pc.snapshot ? &pc.globals : nullptr);
+        lock_guard<mutex> guard(g_jobPoolMutex);
+        if ( generation != g_jobPoolGeneration ) return;
+        for ( auto & pool : g_jobPools ) {
+            if ( pool.source==source && pool.codeId==codeId ) {
+                if ( int(pool.free.size()) < JobQue::get_num_threads() + 1 ) {
+                    pool.free.emplace_back(das::move(pc));
+                }
+                return;
+            }
+        }
+    }
+
+    static void dropJobContextPools () {
+        lock_guard<mutex> guard(g_jobPoolMutex);
+        g_jobPools.clear();
+        g_jobPoolGeneration ++;
+    }
+
+    void new_job_pooled_invoke ( Lambda lambda, Func fn, int32_t lambdaSize, Context * context, LineInfoArg * lineinfo ) {
+        if ( !g_jobQue ) context->throw_error_at(lineinfo, "need to be in 'with_job_que' block");
+        uint64_t generation = 0;
+        auto pc = make_shared<PooledJobContext>(acquirePooledJobContext(context, generation));
+        auto forkContext = pc->context.get();
+        auto ptr = forkContext->allocate(lambdaSize + 16,lineinfo);
+        if ( !ptr ) context->throw_out_of_memory(false, lambdaSize + 16, lineinfo);
+        forkContext->heap->mark_comment(ptr, "new [[ ]] in new_job_pooled");
+        memset ( ptr, 0, lambdaSize + 16 );
+        ptr += 16;
+        das_invoke_function<void>::invoke(forkContext, lineinfo, fn, ptr, lambda.capture);
+        das_delete<Lambda>::clear(context, lambda);
+        auto bound = daScriptEnvironment::bound;
+        auto codeId = context->getCodeAllocatorId();
+        g_jobQue->push([=]() mutable {
+            daScriptEnvironment::bound = bound;
+            Lambda flambda(ptr);
+            das_invoke_lambda<void>::invoke(pc->context.get(), lineinfo, flambda);
+            das_delete<Lambda>::clear(pc->context.get(), flambda);
+            releasePooledJobContext(context, codeId, generation, das::move(*pc));
+        }, 0, JobPriority::Default);
+    }
+
+    urange64 job_pool_stats () {
+        return urange64 ( g_jobPoolReused.load(), g_jobPoolPinned.load() );
+    }
+
     static atomic<int32_t> g_jobQueAvailable{0};
     static atomic<int32_t> g_jobQueTotalThreads{0};
 
@@ -435,6 +1183,95 @@ namespace das {
             lock_guard<mutex> guard(g_jobQueMutex);
             if ( g_jobQue.use_count()==1 ) g_jobQue.reset();
         }
+        if ( !g_jobQue ) dropJobContextPools();
+    }
+
+    // Data parallel for. Range is split into chunks, which are picked up both by the calling thread and by the job que workers.
+    // Workers run the block on worker contexts, which share code and read-only globals with the calling context (see makeWorkerFor),
+    // and have their own heaps. Used portion of the calling context stack is copied to the worker stack at the same offsets,
+    // so that the block sees the locals of the enclosing functions. Block can write to the memory which existed before the call,
+    // i.e. to the elements of the preallocated arrays, but whatever it allocates on the heap is gone once the call is over.
+    // Number of threads, including the calling one, can be limited with maxThreads (0 is all of them).
+    // Nested parallel_for runs on the calling thread, so that workers never wait for each other.
+    static DAS_THREAD_LOCAL int32_t g_parallelForDepth = 0;
+
+    void parallelForInvoke ( int32_t from, int32_t to, int32_t chunkSize, int32_t maxThreads, const TBlock<void,int32_t,int32_t,int32_t> & block, Context * context, LineInfoArg * at ) {
+        if ( !g_jobQue ) context->throw_error_at(at, "need to be in 'with_job_que' block");
+        if ( to <= from ) return;
+        int32_t total = to - from;
+        int32_t maxWorkers = g_parallelForDepth ? 0 : max(g_jobQue->getTotalHwJobs() - 1, 0);
+        if ( maxThreads > 0 ) maxWorkers = min(maxWorkers, maxThreads - 1);
+        if ( chunkSize <= 0 ) chunkSize = max(total / ((maxWorkers + 1) * 4), 1);
+        int32_t totalChunks = int32_t((int64_t(total) + chunkSize - 1) / chunkSize);
+        int32_t totalWorkers = min(maxWorkers, totalChunks - 1);
+        atomic<int32_t> nextChunk{0};
+        atomic<bool> failed{false};
+        auto runChunks = [&]( Context * ctx ) {
+            while ( !failed ) {
+                int32_t chunk = nextChunk++;
+                if ( chunk >= totalChunks ) break;
+                int32_t cfrom = from + chunk * chunkSize;
+                int32_t cto = int32_t(min(int64_t(cfrom) + chunkSize, int64_t(to)));
+                das_invoke<void>::invoke<int32_t,int32_t,int32_t>(ctx,at,block,chunk,cfrom,cto);
+            }
+        };
+        if ( totalWorkers==0 ) {
+            g_parallelForDepth ++;
+            bool ok = context->runWithCatch([&](){ runChunks(context); });
+            g_parallelForDepth --;
+            if ( !ok ) context->throw_error_at(at, "%s", context->getException() ? context->getException() : "unknown exception");
+            return;
+        }
+        // snapshot of the calling stack, from the allocation top to the top of the stack
+        uint32_t stackSize = context->stack.size();
+        uint32_t api = context->stack.api();
+        uint32_t spi = context->stack.spi();
+        vector<char> stackCopy(context->stack.ap(), context->stack.top());
+        JobStatus status(totalWorkers);
+        mutex errorLock;
+        string error;
+        auto bound = daScriptEnvironment::bound;
+        for ( int32_t w=0; w!=totalWorkers; ++w ) {
+            g_jobQue->push([&]() {
+                daScriptEnvironment::bound = bound;
+                {
+                    Context worker(stackSize, context->persistent);
+                    worker.makeWorkerFor(*context);
+                    worker.category.value = uint32_t(ContextCategory::job_clone);
+                    worker.name = "parallel_for worker of " + context->name;
+                    worker.shutdown = true;     // shutdown functions belong to the calling context
+                    if ( worker.persistent ) {
+                        worker.heap = make_smart<PersistentHeapAllocator>();
+                        worker.stringHeap = make_smart<PersistentStringAllocator>();
+                    } else {
+                        worker.heap = make_smart<LinearHeapAllocator>();
+                        worker.stringHeap = make_smart<LinearStringAllocator>();
+                    }
+                    worker.heap->setInitialSize(context->heap->getInitialSize());
+                    worker.heap->setLimit(context->heap->getLimit());
+                    worker.stringHeap->setInitialSize(context->stringHeap->getInitialSize());
+                    worker.stringHeap->setLimit(context->stringHeap->getLimit());
+                    memcpy(worker.stack.bottom() + api, stackCopy.data(), stackCopy.size());
+                    worker.stack.stackTop = worker.stack.bottom() + api;
+                    worker.stack.evalTop = worker.stack.bottom() + spi;
+                    g_parallelForDepth ++;
+                    if ( !worker.runWithCatch([&](){ runChunks(&worker); }) ) {
+                        failed = true;
+                        lock_guard<mutex> guard(errorLock);
+                        if ( error.empty() ) error = worker.getException() ? worker.getException() : "unknown exception";
+                    }
+                    g_parallelForDepth --;
+                }
+                status.Notify();
+            }, 0, JobPriority::Default);
+        }
+        g_parallelForDepth ++;
+        bool ok = context->runWithCatch([&](){ runChunks(context); });
+        g_parallelForDepth --;
+        if ( !ok ) failed = true;
+        status.Wait();
+        if ( !ok ) context->throw_error_at(at, "%s", context->getException() ? context->getException() : "unknown exception");
+        if ( !error.empty() ) context->throw_error_at(at, "%s", error.c_str());
     }
 
     void jobStatusAddRef ( JobStatus * status, Context * context, LineInfoArg * at ) {
@@ -485,6 +1322,39 @@ namespace das {
         status = nullptr;
     }
 
+    JobWakeList * jobWakeListCreate ( Context *, LineInfoArg * ) {
+        JobWakeList * list = new JobWakeList();
+        list->addRef();
+        return list;
+    }
+
+    void jobWakeListRemove ( JobWakeList * & list, Context * context, LineInfoArg * at ) {
+        if ( !list ) context->throw_error_at(at, "wake list is null");
+        if ( !list->isValid() ) context->throw_error_at(at, "wake list is invalid (already deleted?)");
+        if ( list->releaseRef() ) context->throw_error_at(at, "wake list beeing deleted while being used");
+        delete list;
+        list = nullptr;
+    }
+
+    void jobWakeOn ( JobStatus * status, JobWakeList * list, int32_t token, Context * context, LineInfoArg * at ) {
+        if ( !status ) context->throw_error_at(at, "wake_on: status is null");
+        if ( !list ) context->throw_error_at(at, "wake_on: wake list is null");
+        status->addWaiter(list, token);
+    }
+
+    void jobWakeCancel ( JobStatus * status, JobWakeList * list, int32_t token, Context * context, LineInfoArg * at ) {
+        if ( !status ) context->throw_error_at(at, "wake_cancel: status is null");
+        if ( !list ) context->throw_error_at(at, "wake_cancel: wake list is null");
+        status->removeWaiter(list, token);
+    }
+
+    void jobWakeListDrain ( JobWakeList * list, const TBlock<void,int32_t> & blk, Context * context, LineInfoArg * at ) {
+        if ( !list ) context->throw_error_at(at, "wake list is null");
+        list->drain([&]( int32_t token ) {
+            das_invoke<void>::invoke<int32_t>(context, at, blk, token);
+        });
+    }
+
     int getTotalHwJobs( Context * context, LineInfoArg * at ) {
         if ( !g_jobQue ) context->throw_error_at(at, "need to be in 'with_job_que' block");
         return g_jobQue->getTotalHwJobs();
@@ -504,12 +1374,22 @@ namespace das {
             lib.addBuiltInModule();
             // types
             addAnnotation(make_smart<JobStatusAnnotation>(lib));
+            auto jwl = make_smart<JobWakeListAnnotation>(lib);
+            jwl->from("JobStatus");
+            addAnnotation(jwl);
             auto cha = make_smart<ChannelAnnotation>(lib);
             cha->from("JobStatus");
             addAnnotation(cha);
             auto lbx = make_smart<LockBoxAnnotation>(lib);
             lbx->from("JobStatus");
             addAnnotation(lbx);
+            auto rcu = make_smart<RcuBoxAnnotation>(lib);
+            rcu->from("JobStatus");
+            addAnnotation(rcu);
+            addAnnotation(make_smart<MessageArenaAnnotation>(lib));
+            auto aio = make_smart<AsyncIoAnnotation>(lib);
+            aio->from("JobStatus");
+            addAnnotation(aio);
             auto a32 = make_smart<AtomicAnnotation<int32_t>>("Atomic32",lib);
             a32->from("JobStatus");
             addAnnotation(a32);
@@ -579,6 +1459,93 @@ namespace das {
             addExtern<DAS_BIND_FUN(lockBoxUpdate)>(*this, lib,  "_builtin_lockbox_update",
                 SideEffects::modifyArgumentAndExternal, "lockBoxUpdate")
                     ->args({"box","type_info","block","context","line"});
+            // rcu box
+            addExtern<DAS_BIND_FUN(rcuBoxCreate)>(*this, lib, "rcu_box_create",
+                SideEffects::invoke, "rcuBoxCreate")
+                    ->args({ "context","line" });
+            addExtern<DAS_BIND_FUN(rcuBoxRemove)>(*this, lib, "rcu_box_remove",
+                SideEffects::invoke, "rcuBoxRemove")
+                    ->args({ "box", "context","line" })->unsafeOperation = true;
+            addExtern<DAS_BIND_FUN(withRcuBox)>(*this, lib,  "with_rcu_box",
+                SideEffects::invoke, "withRcuBox")
+                    ->args({"block","context","line"});
+            addInterop<rcuBoxSet,void,RcuBox *,vec4f>(*this, lib,  "_builtin_rcubox_set",
+                SideEffects::modifyArgumentAndExternal, "rcuBoxSet")
+                    ->args({"box","data"});
+            addExtern<DAS_BIND_FUN(rcuBoxGet)>(*this, lib,  "_builtin_rcubox_get",
+                SideEffects::modifyArgumentAndExternal, "rcuBoxGet")
+                    ->args({"box","block","context","line"});
+            addExtern<DAS_BIND_FUN(rcuBoxUpdate)>(*this, lib,  "_builtin_rcubox_update",
+                SideEffects::modifyArgumentAndExternal, "rcuBoxUpdate")
+                    ->args({"box","type_info","block","context","line"});
+            addExtern<DAS_BIND_FUN(rcuBoxCollect)>(*this, lib,  "_builtin_rcubox_collect",
+                SideEffects::modifyArgumentAndExternal, "rcuBoxCollect")
+                    ->args({"box","block","context","line"});
+            // message arena
+            addExtern<DAS_BIND_FUN(messageArenaCreate)>(*this, lib, "message_arena_create",
+                SideEffects::modifyExternal, "messageArenaCreate")
+                    ->args({ "page_size","context","line" });
+            addExtern<DAS_BIND_FUN(messageArenaRemove)>(*this, lib, "message_arena_remove",
+                SideEffects::modifyArgumentAndExternal, "messageArenaRemove")
+                    ->args({ "arena","context","line" })->unsafeOperation = true;
+            addExtern<DAS_BIND_FUN(messageArenaAlloc)>(*this, lib, "_builtin_message_arena_alloc",
+                SideEffects::modifyArgumentAndExternal, "messageArenaAlloc")
+                    ->args({ "arena","size","context","line" });
+            addExtern<DAS_BIND_FUN(messageArenaString)>(*this, lib, "message_arena_string",
+                SideEffects::modifyArgumentAndExternal, "messageArenaString")
+                    ->args({ "arena","str","context","line" });
+            addInterop<messageArenaArray,void,MessageArena *,vec4f,int32_t>(*this, lib, "_builtin_message_arena_array",
+                SideEffects::modifyArgumentAndExternal, "messageArenaArray")
+                    ->args({ "arena","array","count" });
+            addExtern<DAS_BIND_FUN(messageArenaPush)>(*this, lib, "_builtin_message_arena_push",
+                SideEffects::modifyArgumentAndExternal, "messageArenaPush")
+                    ->args({ "arena","data","context","line" });
+            addExtern<DAS_BIND_FUN(messageArenaForEach)>(*this, lib, "_builtin_message_arena_for_each",
+                SideEffects::invoke, "messageArenaForEach")
+                    ->args({ "arena","block","context","line" });
+            addExtern<DAS_BIND_FUN(messageArenaConsume)>(*this, lib, "_builtin_message_arena_consume",
+                SideEffects::invoke, "messageArenaConsume")
+                    ->args({ "arena","block","context","line" });
+            addExtern<DAS_BIND_FUN(channelPushArena)>(*this, lib, "_builtin_channel_push_arena",
+                SideEffects::modifyArgumentAndExternal, "channelPushArena")
+                    ->args({ "channel","arena","context","line" });
+            addExtern<DAS_BIND_FUN(channelPopArena)>(*this, lib, "_builtin_channel_pop_arena",
+                SideEffects::modifyArgumentAndExternal, "channelPopArena")
+                    ->args({ "channel","context","line" });
+            // async io
+            addExtern<DAS_BIND_FUN(asyncIoCreate)>(*this, lib, "async_io_create",
+                SideEffects::modifyExternal, "asyncIoCreate")
+                    ->args({ "threads","context","line" });
+            addExtern<DAS_BIND_FUN(asyncIoRemove)>(*this, lib, "async_io_remove",
+                SideEffects::modifyArgumentAndExternal, "asyncIoRemove")
+                    ->args({ "io","context","line" })->unsafeOperation = true;
+            addExtern<DAS_BIND_FUN(withAsyncIo)>(*this, lib,  "with_async_io",
+                SideEffects::invoke, "withAsyncIo")
+                    ->args({"threads","block","context","line"});
+            addExtern<DAS_BIND_FUN(asyncIoRead)>(*this, lib,  "_builtin_async_read",
+                SideEffects::modifyExternal, "asyncIoRead")
+                    ->args({"io","path","channel","context","line"});
+            addExtern<DAS_BIND_FUN(asyncIoReadBatch)>(*this, lib,  "_builtin_async_read_batch",
+                SideEffects::modifyExternal, "asyncIoReadBatch")
+                    ->args({"io","paths","channel","context","line"});
+            addExtern<DAS_BIND_FUN(asyncIoWrite)>(*this, lib,  "_builtin_async_write",
+                SideEffects::modifyExternal, "asyncIoWrite")
+                    ->args({"io","path","data","channel","context","line"});
+            addExtern<DAS_BIND_FUN(asyncIoStat)>(*this, lib,  "_builtin_async_stat",
+                SideEffects::modifyExternal, "asyncIoStat")
+                    ->args({"io","path","channel","context","line"});
+            addExtern<DAS_BIND_FUN(asyncIoDone)>(*this, lib,  "async_done",
+                SideEffects::accessExternal, "asyncIoDone")
+                    ->args({"io","ticket","context","line"});
+            addExtern<DAS_BIND_FUN(asyncIoJoin)>(*this, lib,  "async_join",
+                SideEffects::modifyExternal, "asyncIoJoin")
+                    ->args({"io","ticket","context","line"});
+            addExtern<DAS_BIND_FUN(asyncIoTake)>(*this, lib,  "async_take",
+                SideEffects::modifyExternal, "asyncIoTake")
+                    ->args({"io","ticket","block","context","line"});
+            addExtern<DAS_BIND_FUN(asyncIoDispatch)>(*this, lib,  "_builtin_async_dispatch",
+                SideEffects::modifyExternal, "asyncIoDispatch")
+                    ->args({"io","wait","block","context","line"});
             // channel
             addInterop<channelPush,void,Channel *,vec4f>(*this, lib,  "_builtin_channel_push",
                 SideEffects::modifyArgumentAndExternal, "channelPush")
@@ -644,10 +1611,31 @@ namespace das {
             addExtern<DAS_BIND_FUN(jobStatusRemove)>(*this, lib, "job_status_remove",
                 SideEffects::invoke, "jobStatusRemove")
                     ->args({ "jobStatus", "context","line" })->unsafeOperation = true;
+            // wake list
+            addExtern<DAS_BIND_FUN(jobWakeListCreate)>(*this, lib, "job_wake_list_create",
+                SideEffects::invoke, "jobWakeListCreate")
+                    ->args({ "context","line" });
+            addExtern<DAS_BIND_FUN(jobWakeListRemove)>(*this, lib, "job_wake_list_remove",
+                SideEffects::invoke, "jobWakeListRemove")
+                    ->args({ "list", "context","line" })->unsafeOperation = true;
+            addExtern<DAS_BIND_FUN(jobWakeOn)>(*this, lib, "wake_on",
+                SideEffects::modifyExternal, "jobWakeOn")
+                    ->args({ "status", "list", "token", "context","line" });
+            addExtern<DAS_BIND_FUN(jobWakeCancel)>(*this, lib, "wake_cancel",
+                SideEffects::modifyExternal, "jobWakeCancel")
+                    ->args({ "status", "list", "token", "context","line" });
+            addExtern<DAS_BIND_FUN(jobWakeListDrain)>(*this, lib, "drain",
+                SideEffects::modifyExternal, "jobWakeListDrain")
+                    ->args({ "list", "block", "context","line" });
             // fork \ invoke \ etc
             addExtern<DAS_BIND_FUN(new_job_invoke)>(*this, lib,  "new_job_invoke",
                 SideEffects::modifyExternal, "new_job_invoke")
                     ->args({"lambda","function","lambdaSize","context","line"});
+            addExtern<DAS_BIND_FUN(new_job_pooled_invoke)>(*this, lib,  "new_job_pooled_invoke",
+                SideEffects::modifyExternal, "new_job_pooled_invoke")
+                    ->args({"lambda","function","lambdaSize","context","line"});
+            addExtern<DAS_BIND_FUN(job_pool_stats)>(*this, lib,  "job_pool_stats",
+                SideEffects::accessExternal, "job_pool_stats");
             addExtern<DAS_BIND_FUN(withJobQue)>(*this, lib,  "with_job_que",
                 SideEffects::modifyExternal, "withJobQue")
                     ->args({"block","context","line"});
@@ -656,6 +1644,9 @@ namespace das {
                     ->args({"context","line"});
             addExtern<DAS_BIND_FUN(getTotalHwThreads)>(*this, lib,  "get_total_hw_threads",
                 SideEffects::accessExternal, "getTotalHwThreads");
+            addExtern<DAS_BIND_FUN(parallelForInvoke)>(*this, lib,  "_builtin_parallel_for",
+                SideEffects::modifyExternal, "parallelForInvoke")
+                    ->args({"from","to","chunkSize","maxThreads","block","context","line"});
             addExtern<DAS_BIND_FUN(new_thread_invoke)>(*this, lib,  "new_thread_invoke",
                 SideEffects::modifyExternal, "new_thread_invoke")
                     ->args({"lambda","function","lambdaSize","context","line"});
@@ -224,6 +224,7 @@ namespace das {
     struct ModuleAnnotation : ManagedStructureAnnotation<Module,false> {
         ModuleAnnotation(ModuleLibrary & ml) : ManagedStructureAnnotation ("Module", ml) {
             addField<DAS_BIND_MANAGED_FIELD(name)>("name");
+            addField<DAS_BIND_MANAGED_FIELD(fileName)>("fileName");
             addFieldEx ( "moduleFlags", "moduleFlags", offsetof(Module, moduleFlags), makeModuleFlags() );
         }
     };
@@ -319,6 +320,8 @@ namespace das {
             addField<DAS_BIND_MANAGED_FIELD(debugInfo)>("debugInfo");
             addField<DAS_BIND_MANAGED_FIELD(stackSize)>("stackSize");
             addField<DAS_BIND_MANAGED_FIELD(mangledNameHash)>("mangledNameHash");
+            addProperty<DAS_BIND_MANAGED_PROP(getCallCount)>("callCount","getCallCount");
+            addProperty<DAS_BIND_MANAGED_PROP(getLoopCount)>("loopCount","getLoopCount");
             addProperty<DAS_BIND_MANAGED_PROP(getLineInfo)>("lineInfo","getLineInfo");
             addFieldEx ( "flags", "flags", offsetof(SimFunction, flags), makeSimFunctionFlags() );
         }
@@ -693,6 +696,7 @@ namespace das {
             addField<DAS_BIND_MANAGED_FIELD(aot_module)>("aot_module");
             addField<DAS_BIND_MANAGED_FIELD(completion)>("completion");
             addField<DAS_BIND_MANAGED_FIELD(export_all)>("export_all");
+            addField<DAS_BIND_MANAGED_FIELD(ast_arena)>("ast_arena");
         // reporting
             addField<DAS_BIND_MANAGED_FIELD(always_report_candidates_threshold)>("always_report_candidates_threshold");
         // memory
@@ -791,7 +795,7 @@ namespace das {
         if ( index<0 || index>=tf ) {
             context.throw_error_at(call->debugInfo, "function index out of range, %i of %i", index, tf);
         }
-        FuncInfo * fi = ctx->getFunction(index)->debugInfo;
+        FuncInfo * fi = ctx->requireDebugInfo(ctx->getFunction(index)->debugInfo);
         return cast<FuncInfo *>::from(fi);
     }
 
@@ -1201,9 +1205,9 @@ namespace das {
         return context->allocateString(dt, at);
     }
 
-    const FuncInfo * builtin_get_function_info_by_mnh ( Context &, Func fun ) {
+    const FuncInfo * builtin_get_function_info_by_mnh ( Context & context, Func fun ) {
         if ( fun.PTR ) {
-            return fun.PTR->debugInfo;
+            return context.requireDebugInfo(fun.PTR->debugInfo);
         } else {
             return nullptr;
         }
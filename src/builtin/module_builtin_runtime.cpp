@@ -801,6 +801,10 @@ namespace das
         return context->heap->getTotalAllocations();
     }
 
+    urange64 heap_iterator_pool_stats ( Context * context ) {
+        return urange64 ( context->heap->getIteratorPoolHits(), context->heap->getIteratorPoolBytes() );
+    }
+
     urange64 string_heap_allocation_stats ( Context * context ) {
         return urange64 ( context->stringHeap->getTotalBytesAllocated(), context->stringHeap->getTotalBytesDeleted() );
     }
@@ -825,6 +829,23 @@ namespace das
         return (int32_t) context->stringHeap->depth();
     }
 
+    uint64_t heap_high_watermark ( Context * context ) {
+        return context->heap->getTelemetry().peakBytesInUse.load(std::memory_order_relaxed);
+    }
+
+    uint64_t string_heap_high_watermark ( Context * context ) {
+        return context->stringHeap->getTelemetry().peakBytesInUse.load(std::memory_order_relaxed);
+    }
+
+    void set_heap_telemetry ( bool enabled, Context * context ) {
+        context->heap->setTelemetryEnabled(enabled);
+        context->stringHeap->setTelemetryEnabled(enabled);
+    }
+
+    bool is_heap_telemetry ( Context * context ) {
+        return context->heap->isTelemetryEnabled();
+    }
+
     void string_heap_report ( Context * context, LineInfoArg * info ) {
         context->stringHeap->report();
         context->reportAnyHeap(info, true, false, false, false);
@@ -1664,6 +1685,9 @@ namespace das
         addExtern<DAS_BIND_FUN(heap_allocation_count)>(*this, lib, "heap_allocation_count",
             SideEffects::modifyExternal, "heap_allocation_count")
                 ->arg("context");
+        addExtern<DAS_BIND_FUN(heap_iterator_pool_stats)>(*this, lib, "heap_iterator_pool_stats",
+            SideEffects::modifyExternal, "heap_iterator_pool_stats")
+                ->arg("context");
         addExtern<DAS_BIND_FUN(string_heap_allocation_stats)>(*this, lib, "string_heap_allocation_stats",
             SideEffects::modifyExternal, "string_heap_allocation_stats")
                 ->arg("context");
@@ -1682,6 +1706,18 @@ namespace das
         addExtern<DAS_BIND_FUN(string_heap_depth)>(*this, lib, "string_heap_depth",
             SideEffects::modifyExternal, "string_heap_depth")
                 ->arg("context");
+        addExtern<DAS_BIND_FUN(heap_high_watermark)>(*this, lib, "heap_high_watermark",
+            SideEffects::modifyExternal, "heap_high_watermark")
+                ->arg("context");
+        addExtern<DAS_BIND_FUN(string_heap_high_watermark)>(*this, lib, "string_heap_high_watermark",
+            SideEffects::modifyExternal, "string_heap_high_watermark")
+                ->arg("context");
+        addExtern<DAS_BIND_FUN(set_heap_telemetry)>(*this, lib, "set_heap_telemetry",
+            SideEffects::modifyExternal, "set_heap_telemetry")
+                ->args({"enabled","context"});
+        addExtern<DAS_BIND_FUN(is_heap_telemetry)>(*this, lib, "is_heap_telemetry",
+            SideEffects::accessExternal, "is_heap_telemetry")
+                ->arg("context");
         auto hcol = addExtern<DAS_BIND_FUN(heap_collect)>(*this, lib, "heap_collect",
                 SideEffects::modifyExternal, "heap_collect")
                     ->args({"string_heap","validate","context","at"});
@@ -5,6 +5,8 @@
 #include "daScript/simulate/aot.h"
 #include "daScript/simulate/aot_builtin_jit.h"
 #include "daScript/simulate/aot_builtin_ast.h"
+#include "daScript/simulate/baseline_jit.h"
+#include "daScript/simulate/tier_up.h"
 #include "daScript/ast/ast.h"
 #include "daScript/ast/ast_handle.h"
 #include "daScript/ast/ast_visitor.h"
@@ -33,40 +35,118 @@ namespace das {
         return simfn->code && simfn->code->rtti_node_isJit();
     }
 
+    // clones share SimFunction with the context, and may run on other threads. node is complete before it becomes visible
+    static void das_publish_code ( SimFunction * simfn, SimNode * code ) {
+        static_assert(sizeof(atomic<SimNode *>)==sizeof(SimNode *), "expecting lock-free code pointer");
+        reinterpret_cast<atomic<SimNode *> *>(&simfn->code)->store(code, std::memory_order_release);
+    }
+
     bool das_remove_jit ( const Func func ) {
         auto simfn = func.PTR;
         if ( !simfn ) return false;
         if ( simfn->code && simfn->code->rtti_node_isJit() ) {
             auto jitNode = static_cast<SimNode_Jit *>(simfn->code);
-            simfn->code = jitNode->saved_code;
             simfn->aot = jitNode->saved_aot;
             simfn->aotFunction = jitNode->saved_aot_function;
             simfn->jit = false;
+            das_publish_code(simfn, jitNode->saved_code);
             return true;
         } else {
             return false;
         }
     }
 
-    bool das_instrument_jit ( void * pfun, const Func func, Context & context ) {
+    bool das_install_jit ( void * pfun, const Func func, Context & context ) {
         auto simfn = func.PTR;
         if ( !simfn ) return false;
+        auto node = context.code->makeNode<SimNode_Jit>(LineInfo(), (JitFunction)pfun);
         if ( simfn->code && simfn->code->rtti_node_isJit() ) {
             auto jitNode = static_cast<SimNode_Jit *>(simfn->code);
-            jitNode->func = (JitFunction) pfun;
+            node->saved_code = jitNode->saved_code;
+            node->saved_aot = jitNode->saved_aot;
+            node->saved_aot_function = jitNode->saved_aot_function;
         } else {
-            auto node = context.code->makeNode<SimNode_Jit>(LineInfo(), (JitFunction)pfun);
             node->saved_code = simfn->code;
             node->saved_aot = simfn->aot;
             node->saved_aot_function = simfn->aotFunction;
-            simfn->code = node;
-            simfn->aot = false;
-            simfn->aotFunction = nullptr;
-            simfn->jit = true;
         }
+        simfn->aot = false;
+        simfn->aotFunction = nullptr;
+        simfn->jit = true;
+        das_publish_code(simfn, node);
         return true;
     }
 
+    bool das_instrument_jit ( void * pfun, const Func func, Context & context ) {
+        // tier up service compiles in the background, and reads the code
+        if ( context.tierUp ) {
+            lock_guard<mutex> guard(context.tierUp->getCodeLock());
+            return das_install_jit(pfun, func, context);
+        }
+        return das_install_jit(pfun, func, context);
+    }
+
+    bool das_baseline_jit_available () {
+        return baselineJitAvailable();
+    }
+
+    static int32_t das_baseline_jit_install ( Context & ctx, const vector<SimFunction *> & functions, bool log, Context * context, LineInfoArg * at ) {
+        if ( ctx.hasDebugger() ) context->throw_error_at(at, "baseline jit is not compatible with the debugger");
+        unique_lock<mutex> codeGuard;
+        if ( ctx.tierUp ) codeGuard = unique_lock<mutex>(ctx.tierUp->getCodeLock());
+        vector<JitFunction> code;
+        TextWriter tw;
+        baselineJitCompile(ctx, functions, code, log ? &tw : nullptr);
+        int32_t installed = 0;
+        for ( size_t i=0; i!=functions.size(); ++i ) {
+            if ( code[i] && das_install_jit((void *)code[i], Func(functions[i]), ctx) ) installed ++;
+        }
+        if ( log ) {
+            tw << "baseline jit: " << installed << " of " << int32_t(functions.size()) << " functions\n";
+            context->to_out(at, tw.str().c_str());
+        }
+        return installed;
+    }
+
+    bool das_baseline_jit_function ( const Func func, Context * context, LineInfoArg * at ) {
+        if ( !func.PTR ) context->throw_error_at(at, "expecting function");
+        vector<SimFunction *> functions = { func.PTR };
+        return das_baseline_jit_install(*context, functions, false, context, at)!=0;
+    }
+
+    int32_t das_baseline_jit_context ( Context & ctx, bool log, Context * context, LineInfoArg * at ) {
+        vector<SimFunction *> functions;
+        for ( int32_t i=0, is=ctx.getTotalFunctions(); i!=is; ++i ) {
+            functions.push_back(ctx.getFunction(i));
+        }
+        return das_baseline_jit_install(ctx, functions, log, context, at);
+    }
+
+    void das_start_tier_up ( Context & ctx, uint64_t callThreshold, uint64_t loopThreshold, uint32_t intervalMs, Context * context, LineInfoArg * at ) {
+        if ( ctx.hasDebugger() ) context->throw_error_at(at, "tiered execution is not compatible with the debugger");
+        if ( ctx.tierUp ) delete ctx.tierUp;
+        ctx.tierUp = new TierUpService(ctx, callThreshold, loopThreshold, intervalMs);
+    }
+
+    void das_stop_tier_up ( Context & ctx ) {
+        if ( ctx.tierUp ) {
+            delete ctx.tierUp;
+            ctx.tierUp = nullptr;
+        }
+    }
+
+    // the only place where compiled functions are installed. returns number of functions promoted
+    int32_t das_tier_up_safe_point ( Context & ctx ) {
+        return ctx.tierUp ? ctx.tierUp->safePoint() : 0;
+    }
+
+    char * das_tier_up_report ( Context & ctx, int32_t maxFunctions, Context * context, LineInfoArg * at ) {
+        if ( !ctx.tierUp ) context->throw_error_at(at, "tiered execution is not running");
+        TextWriter tw;
+        ctx.tierUp->reportJson(tw, maxFunctions);
+        return context->allocateString(tw.str(), at);
+    }
+
 extern "C" {
     void jit_exception ( const char * text, Context * context, LineInfoArg * at ) {
         context->throw_error_at(at, "%s", text ? text : "");
@@ -470,6 +550,26 @@ extern "C" {
             addExtern<DAS_BIND_FUN(das_remove_jit)>(*this, lib, "remove_jit",
                 SideEffects::worstDefault, "das_remove_jit")
                     ->args({"function"})->unsafeOperation = true;
+            addExtern<DAS_BIND_FUN(das_baseline_jit_available)>(*this, lib, "baseline_jit_available",
+                SideEffects::none, "das_baseline_jit_available");
+            addExtern<DAS_BIND_FUN(das_baseline_jit_function)>(*this, lib, "baseline_jit",
+                SideEffects::worstDefault, "das_baseline_jit_function")
+                    ->args({"function","context","at"})->unsafeOperation = true;
+            addExtern<DAS_BIND_FUN(das_baseline_jit_context)>(*this, lib, "baseline_jit_context",
+                SideEffects::worstDefault, "das_baseline_jit_context")
+                    ->args({"ctx","log","context","at"})->unsafeOperation = true;
+            addExtern<DAS_BIND_FUN(das_start_tier_up)>(*this, lib, "start_tier_up",
+                SideEffects::worstDefault, "das_start_tier_up")
+                    ->args({"ctx","call_threshold","loop_threshold","interval_ms","context","at"})->unsafeOperation = true;
+            addExtern<DAS_BIND_FUN(das_stop_tier_up)>(*this, lib, "stop_tier_up",
+                SideEffects::worstDefault, "das_stop_tier_up")
+                    ->args({"ctx"})->unsafeOperation = true;
+            addExtern<DAS_BIND_FUN(das_tier_up_safe_point)>(*this, lib, "tier_up_safe_point",
+                SideEffects::worstDefault, "das_tier_up_safe_point")
+                    ->args({"ctx"})->unsafeOperation = true;
+            addExtern<DAS_BIND_FUN(das_tier_up_report)>(*this, lib, "tier_up_report",
+                SideEffects::worstDefault, "das_tier_up_report")
+                    ->args({"ctx","max_functions","context","at"});
             addExtern<DAS_BIND_FUN(das_instrument_line_info)>(*this, lib, "instrument_line_info",
                 SideEffects::worstDefault, "das_instrument_line_info")
                     ->args({"info","context","at"});
@@ -54,6 +54,17 @@ namespace das {
             return context.code->makeNode<SimNode_CopyRefValue>(at, l, r, sizeOf);
         }
     };
+
+    // Function is resolved once, when the call is prepared, and calls go straight to fn->code.
+    // Argument layout is one vec4f per argument, in declaration order (references and boxed values are pointers),
+    // so nArgs is the whole layout. Batch arguments are packed with the stride of nArgs.
+    struct CPreparedCall {
+        Context *       context = nullptr;
+        SimFunction *   fn = nullptr;       // resolved function, never looked up again
+        int32_t         nArgs = 0;          // argument layout, i.e. vec4f slots per call
+        int32_t         argStride = 1;      // same, but at least one slot for the argument buffer
+        vec4f *         args = nullptr;     // argument buffer of das_prepared_call_eval
+    };
 }
 
 das::FileAccessPtr get_file_access( char * pak );//link time resolved dependencies
@@ -194,6 +205,46 @@ char * das_context_get_exception ( das_context * context ) {
     return (char *) ((Context *)context)->getException();
 }
 
+int das_context_eval_batch ( das_context * context, das_function * fun, vec4f * arguments, int args_stride, int count, vec4f * results ) {
+    if ( !fun ) return -1;
+    return ((Context *)context)->evalBatchWithCatch((SimFunction *)fun, arguments, args_stride, count, results);
+}
+
+das_prepared_call * das_context_prepare_call ( das_context * context, das_function * fun, int nargs ) {
+    auto fn = (SimFunction *) fun;
+    if ( !fn || fn->cmres || nargs<0 ) return nullptr;
+    if ( fn->debugInfo && int(fn->debugInfo->count)!=nargs ) return nullptr;
+    auto call = new CPreparedCall();
+    call->context = (Context *) context;
+    call->fn = fn;
+    call->nArgs = nargs;
+    call->argStride = nargs ? nargs : 1;
+    call->args = (vec4f *) das_aligned_alloc16(call->argStride * sizeof(vec4f));
+    memset(call->args, 0, call->argStride * sizeof(vec4f));
+    return (das_prepared_call *) call;
+}
+
+void das_prepared_call_release ( das_prepared_call * call ) {
+    if ( !call ) return;
+    auto pc = (CPreparedCall *) call;
+    das_aligned_free16(pc->args);
+    delete pc;
+}
+
+vec4f * das_prepared_call_arguments ( das_prepared_call * call ) {
+    return ((CPreparedCall *) call)->args;
+}
+
+vec4f das_prepared_call_eval ( das_prepared_call * call ) {
+    auto pc = (CPreparedCall *) call;
+    return pc->context->evalWithCatch(pc->fn, pc->args);
+}
+
+int das_prepared_call_eval_batch ( das_prepared_call * call, vec4f * arguments, int count, vec4f * results ) {
+    auto pc = (CPreparedCall *) call;
+    return pc->context->evalBatchWithCatch(pc->fn, arguments, pc->nArgs, count, results);
+}
+
 void das_error_output ( das_error * error, das_text_writer * tout ) {
     auto err = (Error *) error;
     *((TextWriter *)tout) << reportError(err->at, err->what, err->extra, err->fixme, err->cerr );
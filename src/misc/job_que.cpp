@@ -247,6 +247,7 @@ namespace das {
         --mRemaining;
         if ( mRemaining==0 ) {
             mCond.notify_all();
+            wakeWaiters();
         }
     }
 
@@ -257,6 +258,7 @@ namespace das {
         --mRemaining;
         if ( mRemaining==0 ) {
             mCond.notify_all();
+            wakeWaiters();
         }
     }
 
@@ -267,11 +269,48 @@ namespace das {
         });
     }
 
-    bool JobStatus::isReady() {
+    bool JobStatus::isReady() const {
         lock_guard<mutex> guard(mCompleteMutex);
         return mRemaining==0;
     }
 
+    void JobStatus::addWaiter ( JobWakeList * list, int32_t token ) {
+        lock_guard<mutex> guard(mCompleteMutex);
+        if ( isWaitOver() ) {
+            list->wake(token);
+        } else {
+            mWaiters.emplace_back(list, token);
+        }
+    }
+
+    void JobStatus::removeWaiter ( JobWakeList * list, int32_t token ) {
+        lock_guard<mutex> guard(mCompleteMutex);
+        for ( auto it = mWaiters.begin(); it != mWaiters.end(); ++it ) {
+            if ( it->first==list && it->second==token ) {
+                mWaiters.erase(it);
+                break;
+            }
+        }
+    }
+
+    void JobStatus::wakeWaiters() {
+        for ( auto & w : mWaiters ) {
+            w.first->wake(w.second);
+        }
+        mWaiters.clear();
+    }
+
+    void JobWakeList::wake ( int32_t token ) {
+        lock_guard<mutex> guard(mCompleteMutex);
+        mWoken.push_back(token);
+        mCond.notify_all();
+    }
+
+    bool JobWakeList::isEmpty() const {
+        lock_guard<mutex> guard(mCompleteMutex);
+        return mWoken.empty();
+    }
+
     void JobStatus::Clear(uint32_t count) {
         lock_guard<mutex> guard(mCompleteMutex);
         mRemaining = count;
@@ -10,6 +10,159 @@ void* das_malloc(size_t size){
 void das_free(void* ptr) {
   return eastl::GetDefaultAllocator()->deallocate(ptr, 0);
 }
+
+    DAS_THREAD_LOCAL NodeArena * NodeArena::bound = nullptr;
+
+    struct NodeArenaHeader {
+        void *      chunk;
+        uint64_t    size;
+    };
+    static_assert(sizeof(NodeArenaHeader)==16, "node header must keep 16 byte alignment");
+
+    NodeArena * NodeArena::create ( uint32_t initialSize ) {
+        return new NodeArena(initialSize);
+    }
+
+    NodeArena::NodeArena ( uint32_t initialSize ) {
+        chunkSize = das::max(initialSize, 4096u);
+    }
+
+    NodeArena::~NodeArena() {
+        while ( chunk ) {
+            auto next = chunk->next;
+            das_free(chunk);
+            chunk = next;
+        }
+    }
+
+    void NodeArena::lock() {
+        while ( chunkLock.exchange(true, std::memory_order_acquire) ) {}
+    }
+
+    void NodeArena::unlock() {
+        chunkLock.store(false, std::memory_order_release);
+    }
+
+    void NodeArena::release() {
+        lock();
+        released = true;
+        // nodes on the free lists are dead, chunks which only have those are released right away
+        for ( auto & head : freeList ) {
+            while ( head ) {
+                auto header = ((NodeArenaHeader *) head) - 1;
+                head = head->next;
+                ((Chunk *)header->chunk)->live.fetch_sub(1, std::memory_order_relaxed);
+            }
+        }
+        for ( auto ch = chunk; ch; ) {
+            auto next = ch->next;
+            if ( ch->live.load(std::memory_order_relaxed)==0 ) {
+                freeChunk(ch);
+            }
+            ch = next;
+        }
+        unlock();
+        delRef();
+    }
+
+    void NodeArena::freeChunk ( Chunk * ch ) {
+        // under the lock, only once the arena is released
+        if ( ch->prev ) ch->prev->next = ch->next; else chunk = ch->next;
+        if ( ch->next ) ch->next->prev = ch->prev;
+        reservedBytes -= ch->size;
+        das_free(ch);
+        useCount.fetch_sub(1, std::memory_order_relaxed);  // owner is still referenced by the caller
+    }
+
+    void NodeArena::freeChunkNode ( Chunk * ch ) {
+        lock();
+        bool empty = ch->live.fetch_sub(1, std::memory_order_acq_rel)==1;
+        if ( empty && released ) {
+            freeChunk(ch);
+            bool last = useCount.load(std::memory_order_relaxed)==0;
+            unlock();
+            if ( last ) delete this;
+        } else {
+            unlock();
+        }
+    }
+
+    void NodeArena::delRef() {
+        if ( useCount.fetch_sub(1, std::memory_order_acq_rel)==1 ) {
+            delete this;
+        }
+    }
+
+    void * NodeArena::allocate ( size_t size, Chunk * & owner ) {
+        size = (size + 15) & ~size_t(15);
+        totalNodes ++;
+        auto sizeClass = size >> sizeClassShift;
+        if ( sizeClass < numSizeClasses && freeList[sizeClass] ) {
+            auto node = freeList[sizeClass];
+            freeList[sizeClass] = node->next;
+            auto header = ((NodeArenaHeader *) node) - 1;
+            owner = (Chunk *) header->chunk;    // still counted as live in its chunk
+            reusedNodes ++;
+            return header;
+        }
+        if ( !chunk || chunk->offset + size > chunk->size ) {
+            uint32_t csize = uint32_t(das::max(size_t(chunkSize), size));
+            auto ch = (Chunk *) das_malloc(sizeof(Chunk) + 16 + csize);
+            ch->arena = this;
+            ch->next = chunk;
+            ch->prev = nullptr;
+            ch->size = csize;
+            ch->offset = 0;
+            new (&ch->live) std::atomic<int32_t>(0);
+            lock();
+            if ( chunk ) chunk->prev = ch;
+            chunk = ch;
+            unlock();
+            reservedBytes += csize;
+            useCount.fetch_add(1, std::memory_order_relaxed);
+            chunkSize = das::min(chunkSize * 2, 16u*1024*1024);
+        }
+        char * data = (char *)(((intptr_t(chunk + 1)) + 15) & ~intptr_t(15));
+        void * res = data + chunk->offset;
+        chunk->offset += uint32_t(size);
+        chunk->live.fetch_add(1, std::memory_order_relaxed);
+        totalBytes += size;
+        owner = chunk;
+        return res;
+    }
+
+    void * NodeArena::allocateNode ( size_t size ) {
+        NodeArenaHeader * header;
+        if ( bound ) {
+            Chunk * owner = nullptr;
+            header = (NodeArenaHeader *) bound->allocate(size + sizeof(NodeArenaHeader), owner);
+            header->chunk = owner;
+        } else {
+            header = (NodeArenaHeader *) das_malloc(size + sizeof(NodeArenaHeader));
+            header->chunk = nullptr;
+        }
+        header->size = size;
+        return header + 1;
+    }
+
+    void NodeArena::freeNode ( void * ptr ) {
+        if ( !ptr ) return;
+        auto header = ((NodeArenaHeader *) ptr) - 1;
+        if ( auto ch = (Chunk *) header->chunk ) {
+            auto arena = ch->arena;
+            auto sizeClass = ((header->size + sizeof(NodeArenaHeader) + 15) & ~size_t(15)) >> sizeClassShift;
+            // only the thread the arena is bound to allocates from it, and only that thread touches the free lists
+            if ( arena==bound && !arena->released && sizeClass<numSizeClasses ) {
+                auto node = (FreeNode *) ptr;
+                node->next = arena->freeList[sizeClass];
+                arena->freeList[sizeClass] = node;
+            } else {
+                arena->freeChunkNode(ch);
+            }
+        } else {
+            das_free(header);
+        }
+    }
 #if DAS_TRACK_ALLOCATIONS
     uint64_t    g_tracker = 0;
     uint64_t    g_breakpoint= -1ul;
@@ -31,6 +184,7 @@ void das_free(void* ptr) {
             das_aligned_free16(itb.first);
         }
         bigStuff.clear();
+        bigStuffBytes = 0;
 #if DAS_SANITIZER
         for ( auto & itb : deletedBigStuff ) {
             das_aligned_free16(itb.first);
@@ -70,6 +224,7 @@ void das_free(void* ptr) {
 #endif
             char * ptr = (char *) das_aligned_alloc16(size);
             bigStuff[ptr] = size;
+            bigStuffBytes += size;
 #if DAS_TRACK_ALLOCATIONS
             if ( g_tracker==g_breakpoint ) os_debug_break();
             bigStuffId[ptr] = g_tracker ++;
@@ -84,8 +239,8 @@ void das_free(void* ptr) {
             DAS_ASSERT(size && size<=DAS_MAX_SHOE_ALLOCATION);
             uint32_t si = (size >> 4) - 1;
             uint32_t total = grow(si);
-            shoe.chunks[si] = new Deck(total, size, shoe.chunks[si]);
-            return shoe.chunks[si]->allocate();
+            shoe.addDeck(total, size);
+            return shoe.allocate(size);
         }
 #endif
     }
@@ -119,6 +274,7 @@ void das_free(void* ptr) {
             das_aligned_free16(itb->first);
 #endif
             bigStuff.erase(itb);
+            bigStuffBytes -= size;
             totalAllocated -= size;
 #if DAS_TRACK_ALLOCATIONS
             bigStuffId.erase(ptr);
@@ -161,6 +317,7 @@ void das_free(void* ptr) {
 #endif
         }
         bigStuff.clear();
+        bigStuffBytes = 0;
 #if DAS_TRACK_ALLOCATIONS
         bigStuffId.clear();
         bigStuffAt.clear();
@@ -170,11 +327,7 @@ void das_free(void* ptr) {
     }
 
     uint64_t MemoryModel::totalAlignedMemoryAllocated() const {
-        uint64_t mem = shoe.totalBytesAllocated();
-        for (const auto & it : bigStuff) {
-            mem += it.second;
-        }
-        return mem;
+        return shoe.totalBytesAllocated() + bigStuffBytes;
     }
 
     void MemoryModel::sweep() {
@@ -183,26 +336,28 @@ void das_free(void* ptr) {
         for ( uint32_t si=0; si!=DAS_MAX_SHOE_CUNKS; ++si ) {   // we re-track all small allocations
             for ( auto ch=shoe.chunks[si]; ch; ch=ch->next ) {
                 ch->afterGC();
+                totalAllocated += ch->allocated * ch->size;     // after GC allocated is number of marked entries
+#if DAS_SANITIZER
                 uint32_t utotal = ch->total / 32;
                 for ( uint32_t i=0; i!=utotal; ++i ) {
                     uint32_t b = ch->bits[i];
-                    for ( uint32_t j=0; j!=32; ++j ) {          // TODO: this is COUNTBITS * size
-                        if ( b & (1<<j) ) {
-                            totalAllocated += ch->size;
-                        } else {
-#if DAS_SANITIZER
+                    for ( uint32_t j=0; j!=32; ++j ) {
+                        if ( !(b & (1<<j)) ) {
                             memset ( ch->data + (i*32+j)*ch->size, 0xcd, ch->size );
-#endif
                         }
                     }
                 }
+#endif
             }
         }
+        shoe.bytesInUse = totalAllocated;
 #endif
+        bigStuffBytes = 0;
         for ( auto it = bigStuff.begin(); it!=bigStuff.end() ; ) {
             if ( it->second & DAS_PAGE_GC_MASK ) {
                 it->second &= ~DAS_PAGE_GC_MASK;
                 totalAllocated += it->second;
+                bigStuffBytes += it->second;
                 ++ it;
             } else {
 #if DAS_SANITIZER
@@ -218,7 +373,12 @@ void das_free(void* ptr) {
         if ( !ptr ) return allocate(nsize);
         size = (size + alignMask) & ~alignMask;
         nsize = (nsize + alignMask) & ~alignMask;
-        // TODO: we can 'expand' in certain cases
+        // most recent allocation in the current chunk grows (or shrinks) in place
+        if ( chunk && chunk->isOwnPtr(ptr) && ptr + size == chunk->data + chunk->offset && uint64_t(ptr - chunk->data) + nsize <= chunk->size ) {
+            chunk->offset = uint32_t(ptr - chunk->data) + nsize;
+            bytesInUse = bytesInUse - size + nsize;
+            return ptr;
+        }
         char * nptr = allocate(nsize);
         memcpy ( nptr, ptr, das::min(size,nsize) );
         free(ptr, size);
@@ -229,12 +389,21 @@ void das_free(void* ptr) {
         s = (s + alignMask) & ~alignMask;
         for ( auto ch=chunk; ch; ch=ch->next ) {
             if ( ch->isOwnPtr(ptr) ) {
+                auto offset = ch->offset;
                 ch->free(ptr,s);
+                bytesInUse -= offset - ch->offset;
                 break;
             }
         }
     }
 
+    HeapChunk * LinearChunkAllocator::newChunk ( uint32_t size, HeapChunk * next ) {
+        auto ch = new HeapChunk(size, next);
+        totalChunks ++;
+        bytesReserved += ch->size;
+        return ch;
+    }
+
     uint32_t LinearChunkAllocator::grow ( uint32_t size ) {
         return customGrow ? customGrow(size) : size * 2;
     }
@@ -246,15 +415,16 @@ void das_free(void* ptr) {
             if ( !initialSize ) {
                 initialSize = default_initial_size;
             }
-            chunk = new HeapChunk ( das::max(initialSize, s), nullptr );
+            chunk = newChunk ( das::max(initialSize, s), nullptr );
             // printf("[HC] %i\n", chunk->size);
         }
         for ( ;; ) {
             if ( char * res = chunk->allocate(s) ) {
                 // printf("[A] %i bytes, offs=%i\n", int(s), int(res-chunk->data));
+                bytesInUse += s;
                 return res;
             }
-            chunk = new HeapChunk ( das::max(grow(chunk->size), s), chunk);
+            chunk = newChunk ( das::max(grow(chunk->size), s), chunk);
             // printf("[HC] %i bytes\n", chunk->size);
         }
     }
@@ -265,9 +435,12 @@ void das_free(void* ptr) {
             initialSize = das::max(initialSize, maxAllocated);
             delete chunk;
             chunk = nullptr;
+            totalChunks = 0;
+            bytesReserved = 0;
         } else if ( chunk ) {
             chunk->offset = 0;
         }
+        bytesInUse = 0;
     }
 
     char * LinearChunkAllocator::allocateName ( const string & name ) {
@@ -283,32 +456,9 @@ void das_free(void* ptr) {
     }
 
     void LinearChunkAllocator::getStats ( uint32_t & depth, uint64_t & bytes, uint64_t & total )  const {
-        depth = 0;
-        bytes = 0;
-        total = 0;
-        for ( auto ch=chunk; ch; ch=ch->next ) {
-            depth ++;
-            bytes += ch->offset;
-            total += ch->size;
-        }
-    }
-
-    uint32_t LinearChunkAllocator::depth() const {
-        uint32_t d; uint64_t b, t;
-        getStats(d, b, t);
-        return d;
-    }
-
-    uint64_t LinearChunkAllocator::bytesAllocated() const {
-        uint32_t d; uint64_t b, t;
-        getStats(d, b, t);
-        return b;
-    }
-
-    uint64_t LinearChunkAllocator::totalAlignedMemoryAllocated() const {
-        uint32_t d; uint64_t b, t;
-        getStats(d, b, t);
-        return t;
+        depth = totalChunks;
+        bytes = bytesInUse;
+        total = bytesReserved;
     }
 }
 
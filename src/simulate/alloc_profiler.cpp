@@ -0,0 +1,248 @@
+#include "daScript/misc/platform.h"
+
+#include "daScript/simulate/alloc_profiler.h"
+#include "daScript/simulate/runtime_string.h"
+#include "daScript/misc/anyhash.h"
+
+namespace das {
+
+    #define DAS_ALLOC_PROFILER_MAX_DEPTH    64
+
+    AllocationProfiler::AllocationProfiler ( uint64_t interval, int32_t maxDepth ) {
+        sampleInterval = das::max(interval, uint64_t(1));
+        bytesUntilSample = int64_t(sampleInterval);
+        maxStackDepth = das::min(das::max(maxDepth, 0), DAS_ALLOC_PROFILER_MAX_DEPTH);
+    }
+
+    void AllocationProfiler::reset() {
+        bytesUntilSample = int64_t(sampleInterval);
+        sites.clear();
+        frames.clear();
+        siteLookup.clear();
+        samples.clear();
+        snapshots.clear();
+        totalCount = 0;
+        totalBytes = 0;
+    }
+
+    bool AllocationProfiler::sameSite ( uint32_t si, const LineInfo & at, const StackFrame * stack, uint32_t depth ) const {
+        const auto & site = sites[si];
+        if ( site.at.fileInfo!=at.fileInfo || site.at.line!=at.line || site.at.column!=at.column ) return false;
+        if ( site.stackSize!=depth ) return false;
+        for ( uint32_t fi=0; fi!=depth; ++fi ) {
+            const auto & frame = frames[site.stackOffset + fi];
+            if ( frame.info!=stack[fi].info || frame.line!=stack[fi].line ) return false;
+        }
+        return true;
+    }
+
+    uint32_t AllocationProfiler::captureSite ( Context * context, const LineInfo & at ) {
+        // key is call site, followed by (function, line) of each frame
+        uint64_t key[2 + DAS_ALLOC_PROFILER_MAX_DEPTH*2];
+        StackFrame stack[DAS_ALLOC_PROFILER_MAX_DEPTH];
+        key[0] = uint64_t(intptr_t(at.fileInfo));
+        key[1] = (uint64_t(at.line) << 32) | uint64_t(at.column);
+        uint32_t depth = 0;
+#if DAS_ENABLE_STACK_WALK
+        char * sp = context->stack.ap();
+        while ( sp < context->stack.top() && depth < uint32_t(maxStackDepth) ) {
+            Prologue * pp = (Prologue *) sp;
+            FuncInfo * info = nullptr;
+            if ( pp->info ) {
+                intptr_t iblock = intptr_t(pp->block);
+                info = (iblock & 1) ? ((Block *)(iblock & ~1))->info : pp->info;
+            }
+            uint32_t frameSize = info ? info->stackSize : uint32_t(pp->stackSize);
+            if ( info ) {
+                stack[depth].info = info;
+                stack[depth].line = pp->line;
+                key[2 + depth*2 + 0] = uint64_t(intptr_t(info));
+                key[2 + depth*2 + 1] = uint64_t(intptr_t(pp->line));
+                depth ++;
+            }
+            if ( !frameSize ) break;
+            sp += frameSize;
+        }
+#else
+        (void) context;
+#endif
+        uint64_t hash = hash_block64((const uint8_t *)key, (2 + depth*2) * sizeof(uint64_t));
+        // hash only picks the chain, the site itself is verified frame by frame
+        uint32_t head = ~0u;
+        auto it = siteLookup.find(hash);
+        if ( it != siteLookup.end() ) {
+            head = it->second;
+            for ( uint32_t si=head; si!=~0u; si=sites[si].nextSameHash ) {
+                if ( sameSite(si, at, stack, depth) ) return si;
+            }
+        }
+        uint32_t index = uint32_t(sites.size());
+        Site site;
+        site.nextSameHash = head;
+        site.at = at;
+        site.stackOffset = uint32_t(frames.size());
+        site.stackSize = depth;
+        frames.insert(frames.end(), stack, stack + depth);
+        sites.push_back(site);
+        siteLookup[hash] = index;
+        return index;
+    }
+
+    void AllocationProfiler::onAllocate ( Context * context, void * ptr, uint64_t size, const LineInfo & at ) {
+        bytesUntilSample -= int64_t(size);
+        if ( bytesUntilSample > 0 ) return;
+        // large allocation can cover more than one interval, but it is still one sample
+        bytesUntilSample = int64_t(sampleInterval) - int64_t(uint64_t(-bytesUntilSample) % sampleInterval);
+        onFree(ptr);    // in case we missed free of the previous object at the same address
+        auto si = captureSite(context, at);
+        auto & site = sites[si];
+        site.allocCount ++;
+        site.allocBytes += size;
+        site.liveCount ++;
+        site.liveBytes += size;
+        totalCount ++;
+        totalBytes += size;
+        samples[ptr] = { si, size };
+    }
+
+    void AllocationProfiler::onReallocate ( Context * context, void * ptr, void * newPtr, uint64_t newSize, const LineInfo & at ) {
+        auto it = samples.find(ptr);
+        if ( it == samples.end() ) {
+            onAllocate(context, newPtr, newSize, at);
+            return;
+        }
+        // sampled object keeps its original site
+        auto sample = it->second;
+        samples.erase(it);
+        auto & site = sites[sample.site];
+        site.liveBytes = site.liveBytes - sample.size + newSize;
+        sample.size = newSize;
+        samples[newPtr] = sample;
+    }
+
+    void AllocationProfiler::onFree ( void * ptr ) {
+        if ( samples.empty() ) return;
+        auto it = samples.find(ptr);
+        if ( it == samples.end() ) return;
+        auto & site = sites[it->second.site];
+        site.liveCount --;
+        site.liveBytes -= it->second.size;
+        samples.erase(it);
+    }
+
+    // GC sweep frees whatever is not marked, without onFree. samples, which are no longer allocated, are dropped here
+    void AllocationProfiler::onCollected ( Context * context ) {
+        for ( auto it = samples.begin(); it != samples.end(); ) {
+            auto ptr = (char *) it->first;
+            auto size = (uint32_t(it->second.size) + 15) & ~15;   // heaps look up the size class by rounded size
+            bool alive = true;
+            if ( !size ) {
+                // nothing to look up
+            } else if ( context->heap->isOwnPtr(ptr, size) ) {
+                alive = context->heap->isValidPtr(ptr, size);
+            } else if ( context->stringHeap->isOwnPtr(ptr, size) ) {
+                alive = context->stringHeap->isValidPtr(ptr, size);
+            }
+            if ( alive ) {
+                ++ it;
+                continue;
+            }
+            auto & site = sites[it->second.site];
+            site.liveCount --;
+            site.liveBytes -= it->second.size;
+            it = samples.erase(it);
+        }
+    }
+
+    // heap reset frees everything at once
+    void AllocationProfiler::onHeapsReset() {
+        for ( auto & site : sites ) {
+            site.liveCount = 0;
+            site.liveBytes = 0;
+        }
+        samples.clear();
+    }
+
+    int32_t AllocationProfiler::takeSnapshot() {
+        Snapshot snapshot;
+        for ( uint32_t si=0, sis=uint32_t(sites.size()); si!=sis; ++si ) {
+            const auto & site = sites[si];
+            if ( site.liveCount ) {
+                snapshot.push_back({ si, site.liveCount, site.liveBytes });
+            }
+        }
+        snapshots.push_back(das::move(snapshot));
+        return int32_t(snapshots.size()) - 1;
+    }
+
+    void AllocationProfiler::writeSiteJson ( TextWriter & tw, uint32_t si ) const {
+        const auto & site = sites[si];
+        tw << "\"file\":\"" << (site.at.fileInfo ? escapeString(site.at.fileInfo->name,false) : string()) << "\""
+            << ",\"line\":" << site.at.line << ",\"column\":" << site.at.column
+            << ",\"stack\":[";
+        for ( uint32_t fi=0; fi!=site.stackSize; ++fi ) {
+            const auto & frame = frames[site.stackOffset + fi];
+            if ( fi ) tw << ",";
+            tw << "{\"function\":\"" << escapeString(frame.info->name,false) << "\"";
+            if ( frame.line ) {
+                tw << ",\"file\":\"" << (frame.line->fileInfo ? escapeString(frame.line->fileInfo->name,false) : string()) << "\""
+                    << ",\"line\":" << frame.line->line;
+            }
+            tw << "}";
+        }
+        tw << "]";
+    }
+
+    void AllocationProfiler::reportJson ( TextWriter & tw ) const {
+        tw << "{\"sampleInterval\":" << sampleInterval
+            << ",\"sampledCount\":" << totalCount
+            << ",\"sampledBytes\":" << totalBytes
+            << ",\"sites\":[";
+        for ( uint32_t si=0, sis=uint32_t(sites.size()); si!=sis; ++si ) {
+            const auto & site = sites[si];
+            if ( si ) tw << ",";
+            tw << "{";
+            writeSiteJson(tw, si);
+            tw << ",\"allocCount\":" << site.allocCount << ",\"allocBytes\":" << site.allocBytes
+                << ",\"liveCount\":" << site.liveCount << ",\"liveBytes\":" << site.liveBytes << "}";
+        }
+        tw << "]}";
+    }
+
+    bool AllocationProfiler::diffJson ( TextWriter & tw, int32_t fromSnapshot, int32_t toSnapshot ) const {
+        if ( fromSnapshot<0 || fromSnapshot>=int32_t(snapshots.size()) ) return false;
+        if ( toSnapshot<0 || toSnapshot>=int32_t(snapshots.size()) ) return false;
+        das_hash_map<uint32_t,pair<int64_t,int64_t>> delta;
+        for ( const auto & entry : snapshots[toSnapshot] ) {
+            auto & d = delta[entry.site];
+            d.first += int64_t(entry.liveCount);
+            d.second += int64_t(entry.liveBytes);
+        }
+        for ( const auto & entry : snapshots[fromSnapshot] ) {
+            auto & d = delta[entry.site];
+            d.first -= int64_t(entry.liveCount);
+            d.second -= int64_t(entry.liveBytes);
+        }
+        vector<pair<uint32_t,pair<int64_t,int64_t>>> changed;
+        for ( const auto & d : delta ) {
+            if ( d.second.first || d.second.second ) changed.push_back(d);
+        }
+        // biggest growth first
+        sort(changed.begin(), changed.end(), [](const auto & a, const auto & b){
+            return a.second.second > b.second.second;
+        });
+        tw << "{\"sampleInterval\":" << sampleInterval
+            << ",\"from\":" << fromSnapshot << ",\"to\":" << toSnapshot
+            << ",\"sites\":[";
+        bool first = true;
+        for ( const auto & c : changed ) {
+            if ( !first ) tw << ",";
+            first = false;
+            tw << "{";
+            writeSiteJson(tw, c.first);
+            tw << ",\"deltaCount\":" << c.second.first << ",\"deltaBytes\":" << c.second.second << "}";
+        }
+        tw << "]}";
+        return true;
+    }
+}
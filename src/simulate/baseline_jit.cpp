@@ -0,0 +1,895 @@
+#include "daScript/misc/platform.h"
+
+#include "daScript/simulate/baseline_jit.h"
+
+#if DAS_BASELINE_JIT
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace das {
+
+#if DAS_BASELINE_JIT
+
+    // interpreter entry points, called from generated code for the nodes it does not translate
+extern "C" {
+    vec4f das_baseline_jit_eval ( SimNode * node, Context * context ) {
+        return node->eval(*context);
+    }
+    int32_t das_baseline_jit_eval_int ( SimNode * node, Context * context ) {
+        return node->evalInt(*context);
+    }
+    uint32_t das_baseline_jit_eval_uint ( SimNode * node, Context * context ) {
+        return node->evalUInt(*context);
+    }
+    int64_t das_baseline_jit_eval_int64 ( SimNode * node, Context * context ) {
+        return node->evalInt64(*context);
+    }
+    uint64_t das_baseline_jit_eval_uint64 ( SimNode * node, Context * context ) {
+        return node->evalUInt64(*context);
+    }
+    bool das_baseline_jit_eval_bool ( SimNode * node, Context * context ) {
+        return node->evalBool(*context);
+    }
+}
+
+    BaselineJitCode::~BaselineJitCode() {
+        for ( auto & page : pages ) {
+            munmap(page.data, page.size);
+        }
+    }
+
+    char * BaselineJitCode::commit ( const uint8_t * data, uint32_t size ) {
+        uint64_t pageSize = uint64_t(sysconf(_SC_PAGESIZE));
+        uint64_t bytes = (uint64_t(size) + pageSize - 1) & ~(pageSize - 1);
+        void * mem = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if ( mem==MAP_FAILED ) return nullptr;
+        memcpy(mem, data, size);
+        if ( mprotect(mem, bytes, PROT_READ | PROT_EXEC)!=0 ) {
+            munmap(mem, bytes);
+            return nullptr;
+        }
+        Page page;
+        page.data = (char *) mem;
+        page.size = bytes;
+        lock_guard<mutex> guard(lock);
+        pages.push_back(page);
+        totalBytes += size;
+        return page.data;
+    }
+
+    enum X64Reg : int {
+        x64_rax = 0, x64_rcx = 1, x64_rdx = 2, x64_rbx = 3, x64_rsp = 4, x64_rbp = 5, x64_rsi = 6, x64_rdi = 7, x64_r12 = 12
+    };
+
+    enum X64Cond : uint8_t {
+        x64_b = 0x2, x64_ae = 0x3, x64_e = 0x4, x64_ne = 0x5, x64_be = 0x6, x64_a = 0x7,
+        x64_l = 0xC, x64_ge = 0xD, x64_le = 0xE, x64_g = 0xF
+    };
+
+    enum X64Alu : uint8_t {
+        x64_add = 0x01, x64_or = 0x09, x64_and = 0x21, x64_sub = 0x29, x64_xor = 0x31, x64_cmp = 0x39, x64_mov = 0x89, x64_test = 0x85
+    };
+
+    enum class JitType : uint8_t { none, b8, i32, u32, i64, u64 };
+
+    static JitType jitTypeOf ( const string & name ) {
+        if ( name=="int" ) return JitType::i32;
+        if ( name=="uint" ) return JitType::u32;
+        if ( name=="int64" ) return JitType::i64;
+        if ( name=="uint64" ) return JitType::u64;
+        if ( name=="bool" ) return JitType::b8;
+        return JitType::none;
+    }
+
+    __forceinline bool jit64 ( JitType t ) { return t==JitType::i64 || t==JitType::u64; }
+    __forceinline bool jitSigned ( JitType t ) { return t==JitType::i32 || t==JitType::i64; }
+    __forceinline bool jitNumeric ( JitType t ) { return t!=JitType::none && t!=JitType::b8; }
+
+    // minimal x86-64 assembler. all memory operands are [base+disp32]
+    struct X64Assembler {
+        vector<uint8_t>                 code;
+        vector<int32_t>                 labels;
+        vector<pair<uint32_t,int32_t>>  fixups;     // rel32 offset, label
+        void byte ( uint8_t b ) { code.push_back(b); }
+        void dword ( uint32_t d ) { for ( int i=0; i!=4; ++i ) byte(uint8_t(d>>(i*8))); }
+        void qword ( uint64_t q ) { for ( int i=0; i!=8; ++i ) byte(uint8_t(q>>(i*8))); }
+        int32_t newLabel() { labels.push_back(-1); return int32_t(labels.size()) - 1; }
+        void bind ( int32_t label ) { labels[label] = int32_t(code.size()); }
+        void rel32 ( int32_t label ) { fixups.emplace_back(uint32_t(code.size()), label); dword(0); }
+        void rex ( bool w, int reg, int base ) {
+            uint8_t r = uint8_t(0x40 | (w ? 8 : 0) | ((reg & 8) ? 4 : 0) | ((base & 8) ? 1 : 0));
+            if ( r!=0x40 ) byte(r);
+        }
+        void modrmMem ( int reg, int base, int32_t disp ) {
+            byte(uint8_t(0x80 | ((reg & 7) << 3) | (base & 7)));
+            if ( (base & 7)==x64_rsp ) byte(0x24);
+            dword(uint32_t(disp));
+        }
+        void modrmReg ( int reg, int rm ) { byte(uint8_t(0xC0 | ((reg & 7) << 3) | (rm & 7))); }
+        void load ( JitType t, int reg, int base, int32_t disp ) {
+            if ( t==JitType::b8 ) {
+                rex(false, reg, base); byte(0x0F); byte(0xB6);      // movzx r32, byte
+            } else {
+                rex(jit64(t), reg, base); byte(0x8B);
+            }
+            modrmMem(reg, base, disp);
+        }
+        void store ( JitType t, int reg, int base, int32_t disp ) {
+            rex(jit64(t), reg, base); byte(t==JitType::b8 ? 0x88 : 0x89);
+            modrmMem(reg, base, disp);
+        }
+        void loadPtr ( int reg, int base, int32_t disp ) { rex(true, reg, base); byte(0x8B); modrmMem(reg, base, disp); }
+        void movImm ( int reg, uint64_t imm ) {
+            if ( imm>0xffffffffull ) {
+                rex(true, 0, reg); byte(uint8_t(0xB8 + (reg & 7))); qword(imm);
+            } else {
+                rex(false, 0, reg); byte(uint8_t(0xB8 + (reg & 7))); dword(uint32_t(imm));
+            }
+        }
+        void alu ( X64Alu op, bool w, int dst, int src ) { rex(w, src, dst); byte(op); modrmReg(src, dst); }
+        void imul ( bool w, int dst, int src ) { rex(w, dst, src); byte(0x0F); byte(0xAF); modrmReg(dst, src); }
+        void neg ( bool w, int reg ) { rex(w, 0, reg); byte(0xF7); modrmReg(3, reg); }
+        void bnot ( bool w, int reg ) { rex(w, 0, reg); byte(0xF7); modrmReg(2, reg); }
+        void setccAl ( uint8_t cc ) { byte(0x0F); byte(uint8_t(0x90 + cc)); byte(0xC0); movzxAl(); }
+        void movzxAl() { byte(0x0F); byte(0xB6); byte(0xC0); }
+        void testImmEax ( uint32_t imm ) { byte(0xA9); dword(imm); }
+        void xorImmEax ( uint32_t imm ) { byte(0x35); dword(imm); }
+        void orMem ( int base, int32_t disp, uint32_t imm ) { rex(false, 0, base); byte(0x81); modrmMem(1, base, disp); dword(imm); }
+        void andMem ( int base, int32_t disp, uint32_t imm ) { rex(false, 0, base); byte(0x81); modrmMem(4, base, disp); dword(imm); }
+        void jcc ( uint8_t cc, int32_t label ) { byte(0x0F); byte(uint8_t(0x80 + cc)); rel32(label); }
+        void jmp ( int32_t label ) { byte(0xE9); rel32(label); }
+        void call ( const void * fn ) { movImm(x64_rax, uint64_t(intptr_t(fn))); byte(0xFF); byte(0xD0); }
+        void movupsLoad ( int base, int32_t disp ) { rex(false, 0, base); byte(0x0F); byte(0x10); modrmMem(0, base, disp); }
+        void movupsStore ( int base, int32_t disp ) { rex(false, 0, base); byte(0x0F); byte(0x11); modrmMem(0, base, disp); }
+        void movdXmm0 ( bool w ) { byte(0x66); if ( w ) byte(0x48); byte(0x0F); byte(0x6E); byte(0xC0); }  // movd/movq xmm0, eax/rax
+        void push ( int reg ) { rex(false, 0, reg); byte(uint8_t(0x50 + (reg & 7))); }
+        void pop ( int reg ) { rex(false, 0, reg); byte(uint8_t(0x58 + (reg & 7))); }
+        void adjustRsp ( int32_t delta ) { rex(true, 0, x64_rsp); byte(0x81); modrmReg(delta<0 ? 5 : 0, x64_rsp); dword(uint32_t(delta<0 ? -delta : delta)); }
+        void ret() { byte(0xC3); }
+        bool link() {
+            for ( auto & fx : fixups ) {
+                int32_t target = labels[fx.second];
+                if ( target<0 ) return false;
+                int32_t rel = target - int32_t(fx.first + 4);
+                memcpy(code.data() + fx.first, &rel, 4);
+            }
+            fixups.clear();
+            return true;
+        }
+    };
+
+    // captures name, type and direct operands of the single node, without visiting its children
+    struct JitShapeEvent {
+        enum Kind : uint8_t { sp, number, value, other, sub, list };
+        Kind        kind = other;
+        const char* name = nullptr;
+        uint64_t    bits = 0;           // sp, number, low half of value
+        uint64_t    high = 0;           // high half of value
+        SimNode *   node = nullptr;
+        SimNode **  nodes = nullptr;
+        uint32_t    count = 0;
+    };
+
+    struct JitShape : SimVisitor {
+        string                  name;
+        string                  typeName;
+        vector<JitShapeEvent>   events;
+        void capture ( SimNode * node ) {
+            name.clear();
+            typeName.clear();
+            events.clear();
+            node->visit(*this);
+        }
+        void add ( JitShapeEvent::Kind kind, const char * argN, uint64_t number ) {
+            JitShapeEvent ev;
+            ev.kind = kind;
+            ev.name = argN;
+            ev.bits = number;
+            events.push_back(ev);
+        }
+        virtual void op ( const char * opName, uint32_t, const string & TT ) override {
+            if ( name.empty() ) {
+                name = opName;
+                typeName = TT;
+            }
+        }
+        virtual void sp ( uint32_t stackTop, const char * opN ) override { add(JitShapeEvent::sp, opN, stackTop); }
+        virtual void arg ( int32_t argV, const char * argN ) override { add(JitShapeEvent::number, argN, uint64_t(int64_t(argV))); }
+        virtual void arg ( uint32_t argV, const char * argN ) override { add(JitShapeEvent::number, argN, argV); }
+        virtual void arg ( int64_t argV, const char * argN ) override { add(JitShapeEvent::number, argN, uint64_t(argV)); }
+        virtual void arg ( uint64_t argV, const char * argN ) override { add(JitShapeEvent::number, argN, argV); }
+        virtual void arg ( bool argV, const char * argN ) override { add(JitShapeEvent::number, argN, argV ? 1 : 0); }
+        virtual void arg ( const char *, const char * argN ) override { add(JitShapeEvent::other, argN, 0); }
+        virtual void arg ( float, const char * argN ) override { add(JitShapeEvent::other, argN, 0); }
+        virtual void arg ( double, const char * argN ) override { add(JitShapeEvent::other, argN, 0); }
+        virtual void arg ( Func, const char *, const char * argN ) override { add(JitShapeEvent::other, argN, 0); }
+        virtual void arg ( Func, uint32_t, const char * argN ) override { add(JitShapeEvent::other, argN, 0); }
+        virtual void arg ( vec4f argV, const char * argN ) override {
+            uint64_t halves[2];
+            memcpy(halves, &argV, sizeof(halves));
+            add(JitShapeEvent::value, argN, halves[0]);
+            events.back().high = halves[1];
+        }
+        virtual void sub ( SimNode ** nodes, uint32_t count, const char * opN ) override {
+            add(JitShapeEvent::list, opN, 0);
+            events.back().nodes = nodes;
+            events.back().count = count;
+        }
+        virtual SimNode * sub ( SimNode * node, const char * opN ) override {
+            add(JitShapeEvent::sub, opN, 0);
+            events.back().node = node;
+            return node;
+        }
+        virtual SimNode * visit ( SimNode * node ) override { return node; }
+    };
+
+    // operand of the fused node, or child node of the regular one
+    struct JitSource {
+        enum Kind : uint8_t { none, local, argument, argumentRef, constant, node };
+        Kind        kind = none;
+        uint32_t    index = 0;          // stackTop, or argument index
+        uint64_t    bits = 0;           // constant
+        SimNode *   subexpr = nullptr;
+        bool simple() const { return kind!=node; }
+    };
+
+    struct JitNode {
+        enum Kind : uint8_t {
+            unknown, block, ifThen, ifThenElse, loopWhile, loopRange,
+            ret, retNothing, retConst, retValue,
+            address, load, op1, op2, setOp
+        };
+        Kind        kind = unknown;
+        string      op;                 // operator name without fused source suffixes
+        JitType     type = JitType::none;
+        JitSource   a, b;
+        SimNode *   cond = nullptr;     // if and while condition, range source, return value
+        SimNode *   ifTrue = nullptr;
+        SimNode *   ifFalse = nullptr;
+        SimNode **  list = nullptr;     // block and loop body
+        uint32_t    total = 0;
+        uint32_t    stackTop = 0;       // range loop variable
+        uint64_t    value[2] = { 0, 0 };
+        uint32_t    clearFlags = 0;     // loops
+    };
+
+    static const char * g_jitOp2[] = {
+        "Add", "Sub", "Mul", "BinAnd", "BinOr", "BinXor",
+        "Equ", "NotEqu", "LessEqu", "GtEqu", "Less", "Gt"
+    };
+    static const char * g_jitSetOp[] = {
+        "Set", "SetAdd", "SetSub", "SetMul", "SetBinAnd", "SetBinOr", "SetBinXor"
+    };
+    static const char * g_jitOp1[] = {
+        "Unm", "BinNot", "BoolNot", "Inc", "Dec", "IncPost", "DecPost", "Return"
+    };
+
+    static bool jitIsCompare ( const string & op ) {
+        return op=="Equ" || op=="NotEqu" || op=="LessEqu" || op=="GtEqu" || op=="Less" || op=="Gt";
+    }
+
+    static bool jitIsIncDec ( const string & op ) {
+        return op=="Inc" || op=="Dec" || op=="IncPost" || op=="DecPost";
+    }
+
+    static uint8_t jitCondition ( const string & op, JitType t ) {
+        bool s = jitSigned(t);
+        if ( op=="Equ" ) return x64_e;
+        if ( op=="NotEqu" ) return x64_ne;
+        if ( op=="Less" ) return s ? x64_l : x64_b;
+        if ( op=="LessEqu" ) return s ? x64_le : x64_be;
+        if ( op=="Gt" ) return s ? x64_g : x64_a;
+        return s ? x64_ge : x64_ae;
+    }
+
+    static bool jitTypeFits ( const string & op, JitType t ) {
+        if ( t==JitType::none ) return false;
+        if ( t==JitType::b8 ) return op=="Equ" || op=="NotEqu" || op=="Set" || op=="BoolNot" || op=="Return";
+        return op!="BoolNot";
+    }
+
+    class BaselineJitCompiler {
+    public:
+        BaselineJitCompiler ( Context & ctx ) : context(ctx) {
+            offStopFlags = int32_t(offsetof(Context, stopFlags));
+            offResult = int32_t(offsetof(Context, result));
+            offEvalTop = int32_t(offsetof(Context, stack) + offsetof(StackAllocator, evalTop));
+        }
+        bool compileFunction ( SimFunction * fn ) {
+            nativeNodes = 0;
+            fallbackNodes = 0;
+            spillDepth = 0;
+            // push rbp; mov rbp, rsp; push rbx; push r12; keeps rsp aligned for calls
+            as.push(x64_rbp);
+            as.alu(x64_mov, true, x64_rbp, x64_rsp);
+            as.push(x64_rbx);
+            as.push(x64_r12);
+            as.adjustRsp(-int32_t(maxSpill*8));
+            as.alu(x64_mov, true, x64_rbx, x64_rdi);            // rbx = context
+            as.alu(x64_mov, true, x64_r12, x64_rsi);            // r12 = arguments
+            exitLabel = as.newLabel();
+            compileStatement(fn->code);
+            as.bind(exitLabel);
+            as.movupsLoad(x64_rbx, offResult);                  // return context.result
+            as.adjustRsp(int32_t(maxSpill*8));
+            as.pop(x64_r12);
+            as.pop(x64_rbx);
+            as.pop(x64_rbp);
+            as.ret();
+            return nativeNodes!=0;
+        }
+    public:
+        X64Assembler    as;
+        uint32_t        nativeNodes = 0;
+        uint32_t        fallbackNodes = 0;
+    protected:
+        struct JitLoop {
+            int32_t continueLabel;
+            int32_t breakLabel;
+        };
+        static constexpr uint32_t maxSpill = 32;
+        Context &       context;
+        JitShape        shape;
+        int32_t         exitLabel = -1;
+        uint32_t        spillDepth = 0;
+        int32_t         offStopFlags = 0;
+        int32_t         offResult = 0;
+        int32_t         offEvalTop = 0;
+    protected:
+        // decoding
+        bool takeSource ( JitSource::Kind kind, uint32_t & cursor, JitSource & src ) {
+            auto & ev = shape.events;
+            if ( cursor>=ev.size() ) return false;
+            auto & e = ev[cursor++];
+            src.kind = kind;
+            switch ( kind ) {
+            case JitSource::local:
+            case JitSource::argument:
+            case JitSource::argumentRef:
+                if ( e.kind!=JitShapeEvent::sp ) return false;
+                src.index = uint32_t(e.bits);
+                return true;
+            case JitSource::constant:
+                if ( e.kind!=JitShapeEvent::value ) return false;
+                src.bits = e.bits;
+                return true;
+            case JitSource::node:
+                if ( e.kind!=JitShapeEvent::sub ) return false;
+                src.subexpr = e.node;
+                return true;
+            default:
+                return false;
+            }
+        }
+        static bool parseSourceName ( const char * & at, JitSource::Kind & kind ) {
+            static const pair<const char *,JitSource::Kind> names[] = {
+                { "Any", JitSource::node }, { "Const", JitSource::constant }, { "Loc", JitSource::local },
+                { "Argr", JitSource::argumentRef }, { "Arg", JitSource::argument }
+            };
+            for ( auto & nk : names ) {
+                size_t len = strlen(nk.first);
+                if ( strncmp(at, nk.first, len)==0 ) {
+                    // Argr vs Arg+r... is resolved by the caller, which requires the whole name to be consumed
+                    const char * next = at + len;
+                    if ( *next==0 || (*next>='A' && *next<='Z') ) {
+                        at = next;
+                        kind = nk.second;
+                        return true;
+                    }
+                }
+            }
+            return false;
+        }
+        // fused node name is operator, followed by one source name per operand (see getSimSourceName)
+        bool decodeFused ( const char * const * ops, size_t nops, uint32_t nsrc, JitNode & jn ) {
+            const string & name = shape.name;
+            for ( size_t i=0; i!=nops; ++i ) {
+                size_t len = strlen(ops[i]);
+                if ( name.size()<=len || name.compare(0, len, ops[i])!=0 ) continue;
+                const char * at = name.c_str() + len;
+                JitSource::Kind kinds[2] = { JitSource::none, JitSource::none };
+                bool ok = true;
+                for ( uint32_t s=0; s!=nsrc && ok; ++s ) ok = parseSourceName(at, kinds[s]);
+                if ( !ok || *at ) continue;
+                uint32_t cursor = 0;
+                if ( !takeSource(kinds[0], cursor, jn.a) ) return false;
+                if ( nsrc==2 && !takeSource(kinds[1], cursor, jn.b) ) return false;
+                if ( cursor!=shape.events.size() ) return false;
+                jn.op = ops[i];
+                return true;
+            }
+            return false;
+        }
+        bool decodePlain ( const char * const * ops, size_t nops, uint32_t nsub, JitNode & jn ) {
+            for ( size_t i=0; i!=nops; ++i ) {
+                if ( shape.name!=ops[i] ) continue;
+                uint32_t cursor = 0;
+                if ( !takeSource(JitSource::node, cursor, jn.a) ) return false;
+                if ( nsub==2 && !takeSource(JitSource::node, cursor, jn.b) ) return false;
+                if ( cursor!=shape.events.size() ) return false;
+                jn.op = ops[i];
+                return true;
+            }
+            return false;
+        }
+        // regular node, which computes address of the local variable
+        bool decodeAddress ( JitSource & src ) {
+            if ( src.kind!=JitSource::node ) return src.kind==JitSource::local || src.kind==JitSource::argumentRef;
+            shape.capture(src.subexpr);
+            if ( shape.name!="GetLocal" || shape.events.size()!=1 || shape.events[0].kind!=JitShapeEvent::sp ) return false;
+            src.kind = JitSource::local;
+            src.index = uint32_t(shape.events[0].bits);
+            src.subexpr = nullptr;
+            return true;
+        }
+        bool decodeLoop ( SimNode * node, JitNode & jn ) {
+            auto blk = static_cast<SimNode_Block *>(node);
+            if ( blk->totalLabels || blk->totalFinal ) return false;
+            jn.list = blk->list;
+            jn.total = blk->total;
+            return true;
+        }
+        bool decode ( SimNode * node, JitNode & jn ) {
+            shape.capture(node);
+            const string & name = shape.name;
+            auto & ev = shape.events;
+            jn.type = jitTypeOf(shape.typeName);
+            if ( name=="Block" || name=="Let" ) {
+                // closure blocks report needResult, and are never statements anyway
+                for ( auto & e : ev ) if ( e.kind!=JitShapeEvent::list ) return false;
+                auto blk = static_cast<SimNode_Block *>(node);
+                if ( blk->totalFinal ) return false;
+                jn.kind = JitNode::block;
+                jn.list = blk->list;
+                jn.total = blk->total;
+                return true;
+            } else if ( name=="IfThen" || name=="IfThenElse" ) {
+                bool hasElse = name=="IfThenElse";
+                if ( ev.size()!=(hasElse ? 3u : 2u) ) return false;
+                for ( auto & e : ev ) if ( e.kind!=JitShapeEvent::sub ) return false;
+                jn.kind = hasElse ? JitNode::ifThenElse : JitNode::ifThen;
+                jn.cond = ev[0].node;
+                jn.ifTrue = ev[1].node;
+                jn.ifFalse = hasElse ? ev[2].node : nullptr;
+                return true;
+            } else if ( name=="While" ) {
+                if ( ev.empty() || ev[0].kind!=JitShapeEvent::sub ) return false;
+                jn.kind = JitNode::loopWhile;
+                jn.cond = ev[0].node;
+                jn.clearFlags = EvalFlags::stopForBreak;
+                return decodeLoop(node, jn);
+            } else if ( name=="ForRange" || name=="ForRangeNF" || name=="ForRange1" || name=="ForRangeNF1" ) {
+                if ( !jitNumeric(jn.type) ) return false;
+                if ( ev.size()<2 || ev[0].kind!=JitShapeEvent::sp || ev[1].kind!=JitShapeEvent::sub ) return false;
+                jn.kind = JitNode::loopRange;
+                jn.stackTop = uint32_t(ev[0].bits);
+                jn.cond = ev[1].node;
+                jn.clearFlags = name=="ForRange" ? EvalFlags::stopForBreak : (EvalFlags::stopForBreak | EvalFlags::stopForContinue);
+                return decodeLoop(node, jn);
+            } else if ( name=="Return" ) {
+                if ( ev.size()>1 || (ev.size()==1 && ev[0].kind!=JitShapeEvent::sub) ) return false;
+                jn.kind = JitNode::ret;
+                jn.cond = ev.size() ? ev[0].node : nullptr;
+                return true;
+            } else if ( name=="ReturnNothing" ) {
+                jn.kind = JitNode::retNothing;
+                return ev.empty();
+            } else if ( name=="ReturnConst" ) {
+                if ( ev.size()!=1 || ev[0].kind!=JitShapeEvent::value ) return false;
+                jn.kind = JitNode::retConst;
+                jn.value[0] = ev[0].bits;
+                jn.value[1] = ev[0].high;
+                return true;
+            } else if ( name=="GetLocal" ) {
+                uint32_t cursor = 0;
+                jn.kind = JitNode::address;
+                return takeSource(JitSource::local, cursor, jn.a) && cursor==ev.size();
+            } else if ( name=="GetLocalR2V" || name=="GetArgument" || name=="ConstValue" ) {
+                uint32_t cursor = 0;
+                auto kind = name=="GetLocalR2V" ? JitSource::local : (name=="GetArgument" ? JitSource::argument : JitSource::constant);
+                jn.kind = JitNode::load;
+                return takeSource(kind, cursor, jn.a) && cursor==ev.size();
+            }
+            constexpr size_t nOp2 = sizeof(g_jitOp2)/sizeof(g_jitOp2[0]);
+            constexpr size_t nSetOp = sizeof(g_jitSetOp)/sizeof(g_jitSetOp[0]);
+            constexpr size_t nOp1 = sizeof(g_jitOp1)/sizeof(g_jitOp1[0]);
+            if ( decodePlain(g_jitOp2, nOp2, 2, jn) || decodeFused(g_jitOp2, nOp2, 2, jn) ) {
+                jn.kind = JitNode::op2;
+            } else if ( decodePlain(g_jitSetOp, nSetOp, 2, jn) || decodeFused(g_jitSetOp, nSetOp, 2, jn) ) {
+                jn.kind = JitNode::setOp;
+                if ( !jitTypeFits(jn.op, jn.type) ) return false;
+                return decodeAddress(jn.a);
+            } else if ( decodePlain(g_jitOp1, nOp1-1, 1, jn) || decodeFused(g_jitOp1, nOp1, 1, jn) ) {
+                jn.kind = jn.op=="Return" ? JitNode::retValue : JitNode::op1;
+                if ( !jitTypeFits(jn.op, jn.type) ) return false;
+                return jitIsIncDec(jn.op) ? decodeAddress(jn.a) : true;
+            } else {
+                return false;
+            }
+            return jitTypeFits(jn.op, jn.type);
+        }
+    protected:
+        // code generation helpers
+        void callNode ( const void * fn, SimNode * node ) {
+            as.movImm(x64_rdi, uint64_t(intptr_t(node)));
+            as.alu(x64_mov, true, x64_rsi, x64_rbx);
+            as.call(fn);
+        }
+        void fallbackStatement ( SimNode * node ) {
+            callNode((const void *)&das_baseline_jit_eval, node);
+            fallbackNodes ++;
+        }
+        void fallbackValue ( SimNode * node, JitType t ) {
+            switch ( t ) {
+            case JitType::i32:  callNode((const void *)&das_baseline_jit_eval_int, node); break;
+            case JitType::u32:  callNode((const void *)&das_baseline_jit_eval_uint, node); break;
+            case JitType::i64:  callNode((const void *)&das_baseline_jit_eval_int64, node); break;
+            case JitType::u64:  callNode((const void *)&das_baseline_jit_eval_uint64, node); break;
+            default:            callNode((const void *)&das_baseline_jit_eval_bool, node); as.movzxAl(); break;
+            }
+            fallbackNodes ++;
+        }
+        void jumpIfStopped ( int32_t label ) {
+            as.load(JitType::u32, x64_rax, x64_rbx, offStopFlags);
+            as.alu(x64_test, false, x64_rax, x64_rax);
+            as.jcc(x64_ne, label);
+        }
+        // same as DAS_PROCESS_LOOP_FLAGS for the loop without labels
+        void loopCheck ( const JitLoop & loop ) {
+            auto next = as.newLabel();
+            as.load(JitType::u32, x64_rax, x64_rbx, offStopFlags);
+            as.alu(x64_test, false, x64_rax, x64_rax);
+            as.jcc(x64_e, next);
+            as.testImmEax(EvalFlags::stopForContinue);
+            as.jcc(x64_e, loop.breakLabel);
+            as.andMem(x64_rbx, offStopFlags, ~uint32_t(EvalFlags::stopForContinue));
+            as.jmp(loop.continueLabel);
+            as.bind(next);
+        }
+        void loadSource ( const JitSource & src, JitType t, int reg ) {
+            switch ( src.kind ) {
+            case JitSource::local:
+                as.loadPtr(x64_rdx, x64_rbx, offEvalTop);
+                as.load(t, reg, x64_rdx, int32_t(src.index));
+                break;
+            case JitSource::argument:
+                as.load(t, reg, x64_r12, int32_t(src.index*sizeof(vec4f)));
+                break;
+            case JitSource::argumentRef:
+                as.loadPtr(x64_rdx, x64_r12, int32_t(src.index*sizeof(vec4f)));
+                as.load(t, reg, x64_rdx, 0);
+                break;
+            case JitSource::constant: {
+                    uint64_t bits = src.bits;
+                    if ( t==JitType::b8 ) bits = (bits & 0xff) ? 1 : 0;
+                    else if ( !jit64(t) ) bits &= 0xffffffffull;
+                    as.movImm(reg, bits);
+                }
+                break;
+            default:
+                compileValue(src.subexpr, t);
+                if ( reg!=x64_rax ) as.alu(x64_mov, true, reg, x64_rax);
+                break;
+            }
+        }
+        // rdx + returned displacement is the address of the source
+        int32_t addressSource ( const JitSource & src ) {
+            if ( src.kind==JitSource::local ) {
+                as.loadPtr(x64_rdx, x64_rbx, offEvalTop);
+                return int32_t(src.index);
+            } else {
+                as.loadPtr(x64_rdx, x64_r12, int32_t(src.index*sizeof(vec4f)));
+                return 0;
+            }
+        }
+        // left operand goes to rax, right one to rcx. returns false if out of spill slots
+        bool loadOperands ( const JitNode & jn ) {
+            if ( jn.b.simple() ) {
+                loadSource(jn.a, jn.type, x64_rax);
+                loadSource(jn.b, jn.type, x64_rcx);
+            } else if ( jn.a.kind==JitSource::constant ) {
+                loadSource(jn.b, jn.type, x64_rax);
+                as.alu(x64_mov, true, x64_rcx, x64_rax);
+                loadSource(jn.a, jn.type, x64_rax);
+            } else {
+                if ( spillDepth>=maxSpill ) return false;
+                int32_t slot = int32_t(spillDepth++ * 8);
+                loadSource(jn.a, jn.type, x64_rax);
+                as.store(JitType::u64, x64_rax, x64_rsp, slot);
+                loadSource(jn.b, jn.type, x64_rax);
+                as.alu(x64_mov, true, x64_rcx, x64_rax);
+                as.load(JitType::u64, x64_rax, x64_rsp, slot);
+                spillDepth --;
+            }
+            return true;
+        }
+        void arithmetic ( const string & op, JitType t ) {       // rax = rax op rcx
+            bool w = jit64(t);
+            if ( op=="Add" || op=="SetAdd" || op=="Inc" || op=="IncPost" ) as.alu(x64_add, w, x64_rax, x64_rcx);
+            else if ( op=="Sub" || op=="SetSub" || op=="Dec" || op=="DecPost" ) as.alu(x64_sub, w, x64_rax, x64_rcx);
+            else if ( op=="Mul" || op=="SetMul" ) as.imul(w, x64_rax, x64_rcx);
+            else if ( op=="BinAnd" || op=="SetBinAnd" ) as.alu(x64_and, w, x64_rax, x64_rcx);
+            else if ( op=="BinOr" || op=="SetBinOr" ) as.alu(x64_or, w, x64_rax, x64_rcx);
+            else if ( op=="BinXor" || op=="SetBinXor" ) as.alu(x64_xor, w, x64_rax, x64_rcx);
+        }
+        // result in rax. returns true if value was computed natively
+        bool compileValue ( SimNode * node, JitType t ) {
+            JitNode jn;
+            if ( decode(node, jn) ) {
+                if ( jn.kind==JitNode::load ) {
+                    if ( jn.type==JitType::none || jn.type==t ) {
+                        loadSource(jn.a, t, x64_rax);
+                        nativeNodes ++;
+                        return true;
+                    }
+                } else if ( jn.kind==JitNode::op2 ) {
+                    bool cmp = jitIsCompare(jn.op);
+                    if ( (cmp ? JitType::b8 : jn.type)==t && (cmp || jitNumeric(t)) && loadOperands(jn) ) {
+                        if ( cmp ) {
+                            as.alu(x64_cmp, jit64(jn.type), x64_rax, x64_rcx);
+                            as.setccAl(jitCondition(jn.op, jn.type));
+                        } else {
+                            arithmetic(jn.op, t);
+                        }
+                        nativeNodes ++;
+                        return true;
+                    }
+                } else if ( jn.kind==JitNode::op1 && jn.type==t ) {
+                    if ( jitIsIncDec(jn.op) ) {
+                        int32_t disp = addressSource(jn.a);
+                        as.load(t, x64_rax, x64_rdx, disp);
+                        as.movImm(x64_rcx, 1);
+                        if ( jn.op=="IncPost" || jn.op=="DecPost" ) {
+                            // rcx = rax -/+ 1 is stored, rax is the old value
+                            as.alu(jn.op=="IncPost" ? x64_add : x64_sub, jit64(t), x64_rcx, x64_rax);
+                            if ( jn.op=="DecPost" ) as.neg(jit64(t), x64_rcx);
+                            as.store(t, x64_rcx, x64_rdx, disp);
+                        } else {
+                            arithmetic(jn.op, t);
+                            as.store(t, x64_rax, x64_rdx, disp);
+                        }
+                    } else {
+                        loadSource(jn.a, t, x64_rax);
+                        if ( jn.op=="Unm" ) as.neg(jit64(t), x64_rax);
+                        else if ( jn.op=="BinNot" ) as.bnot(jit64(t), x64_rax);
+                        else as.xorImmEax(1);                       // BoolNot
+                    }
+                    nativeNodes ++;
+                    return true;
+                }
+            }
+            fallbackValue(node, t);
+            return false;
+        }
+        // jumps to falseLabel, unless condition is true. returns true if condition was computed natively
+        bool compileCondition ( SimNode * node, int32_t falseLabel ) {
+            JitNode jn;
+            if ( decode(node, jn) && jn.kind==JitNode::op2 && jitIsCompare(jn.op) && loadOperands(jn) ) {
+                as.alu(x64_cmp, jit64(jn.type), x64_rax, x64_rcx);
+                as.jcc(uint8_t(jitCondition(jn.op, jn.type) ^ 1), falseLabel);
+                nativeNodes ++;
+                return true;
+            }
+            bool native = compileValue(node, JitType::b8);
+            as.alu(x64_test, false, x64_rax, x64_rax);
+            as.jcc(x64_e, falseLabel);
+            return native;
+        }
+        // returns true if statements may leave stopFlags set
+        bool compileList ( SimNode ** list, uint32_t total, const JitLoop * loop ) {
+            bool mayStop = false;
+            auto endLabel = as.newLabel();
+            for ( uint32_t i=0; i!=total; ++i ) {
+                if ( compileStatement(list[i]) ) {
+                    if ( loop ) loopCheck(*loop);
+                    else if ( i+1!=total ) jumpIfStopped(endLabel);
+                    mayStop = true;
+                }
+            }
+            as.bind(endLabel);
+            return mayStop;
+        }
+        void storeResult ( JitType t ) {
+            as.movdXmm0(jit64(t));
+            as.movupsStore(x64_rbx, offResult);
+        }
+        void emitReturn() {
+            as.orMem(x64_rbx, offStopFlags, EvalFlags::stopForReturn);
+            as.jmp(exitLabel);
+            nativeNodes ++;
+        }
+        bool compileStatement ( SimNode * node ) {
+            JitNode jn;
+            if ( !decode(node, jn) ) {
+                fallbackStatement(node);
+                return true;
+            }
+            switch ( jn.kind ) {
+            case JitNode::block:
+                return compileList(jn.list, jn.total, nullptr);
+            case JitNode::ifThen:
+            case JitNode::ifThenElse: {
+                    auto elseLabel = as.newLabel();
+                    auto endLabel = as.newLabel();
+                    compileCondition(jn.cond, elseLabel);
+                    bool mayStop = compileStatement(jn.ifTrue);
+                    if ( jn.ifFalse ) as.jmp(endLabel);
+                    as.bind(elseLabel);
+                    if ( jn.ifFalse ) mayStop |= compileStatement(jn.ifFalse);
+                    as.bind(endLabel);
+                    nativeNodes ++;
+                    return mayStop;
+                }
+            case JitNode::loopWhile: {
+                    JitLoop loop = { as.newLabel(), as.newLabel() };
+                    as.bind(loop.continueLabel);
+                    if ( !compileCondition(jn.cond, loop.breakLabel) ) jumpIfStopped(loop.breakLabel);
+                    bool mayStop = compileList(jn.list, jn.total, &loop);
+                    as.jmp(loop.continueLabel);
+                    as.bind(loop.breakLabel);
+                    as.andMem(x64_rbx, offStopFlags, ~jn.clearFlags);
+                    nativeNodes ++;
+                    return mayStop;
+                }
+            case JitNode::loopRange: {
+                    if ( spillDepth+3>maxSpill ) break;
+                    // range (16 bytes) and loop counter live in the spill slots
+                    int32_t slotRange = int32_t(spillDepth*8);
+                    int32_t slotI = slotRange + 16;
+                    spillDepth += 3;
+                    JitType t = jn.type;
+                    bool w = jit64(t);
+                    int32_t slotTo = slotRange + (w ? 8 : 4);
+                    JitLoop loop = { as.newLabel(), as.newLabel() };
+                    auto topLabel = as.newLabel();
+                    callNode((const void *)&das_baseline_jit_eval, jn.cond);
+                    as.movupsStore(x64_rsp, slotRange);
+                    as.load(t, x64_rax, x64_rsp, slotRange);
+                    as.store(t, x64_rax, x64_rsp, slotI);
+                    as.load(t, x64_rcx, x64_rsp, slotTo);
+                    as.alu(x64_cmp, w, x64_rax, x64_rcx);
+                    as.jcc(jitSigned(t) ? x64_ge : x64_ae, loop.breakLabel);
+                    as.bind(topLabel);
+                    as.load(t, x64_rax, x64_rsp, slotI);
+                    as.loadPtr(x64_rdx, x64_rbx, offEvalTop);
+                    as.store(t, x64_rax, x64_rdx, int32_t(jn.stackTop));
+                    bool mayStop = compileList(jn.list, jn.total, &loop);
+                    as.bind(loop.continueLabel);
+                    as.load(t, x64_rax, x64_rsp, slotI);
+                    as.movImm(x64_rcx, 1);
+                    as.alu(x64_add, w, x64_rax, x64_rcx);
+                    as.store(t, x64_rax, x64_rsp, slotI);
+                    as.load(t, x64_rcx, x64_rsp, slotTo);
+                    as.alu(x64_cmp, w, x64_rax, x64_rcx);
+                    as.jcc(x64_ne, topLabel);
+                    as.bind(loop.breakLabel);
+                    as.andMem(x64_rbx, offStopFlags, ~jn.clearFlags);
+                    spillDepth -= 3;
+                    nativeNodes ++;
+                    return mayStop;
+                }
+            case JitNode::ret:
+                if ( jn.cond ) {
+                    JitNode val;
+                    JitType t = JitType::none;
+                    if ( decode(jn.cond, val) ) {
+                        if ( val.kind==JitNode::op2 && jitIsCompare(val.op) ) t = JitType::b8;
+                        else if ( val.kind==JitNode::op2 || val.kind==JitNode::op1 || val.kind==JitNode::load ) t = val.type;
+                    }
+                    if ( t!=JitType::none ) {
+                        compileValue(jn.cond, t);
+                        storeResult(t);
+                    } else {
+                        callNode((const void *)&das_baseline_jit_eval, jn.cond);
+                        as.movupsStore(x64_rbx, offResult);
+                        fallbackNodes ++;
+                    }
+                }
+                emitReturn();
+                return false;
+            case JitNode::retNothing:
+                emitReturn();
+                return false;
+            case JitNode::retConst:
+                as.movImm(x64_rax, jn.value[0]);
+                as.store(JitType::u64, x64_rax, x64_rbx, offResult);
+                as.movImm(x64_rax, jn.value[1]);
+                as.store(JitType::u64, x64_rax, x64_rbx, offResult + 8);
+                emitReturn();
+                return false;
+            case JitNode::retValue:
+                loadSource(jn.a, jn.type, x64_rax);
+                storeResult(jn.type);
+                emitReturn();
+                return false;
+            case JitNode::setOp: {
+                    // value first, computing it may clobber rdx. address is always local or argument reference
+                    loadSource(jn.b, jn.type, x64_rax);
+                    int32_t disp = addressSource(jn.a);
+                    if ( jn.op!="Set" ) {
+                        as.alu(x64_mov, true, x64_rcx, x64_rax);
+                        as.load(jn.type, x64_rax, x64_rdx, disp);
+                        arithmetic(jn.op, jn.type);
+                    }
+                    as.store(jn.type, x64_rax, x64_rdx, disp);
+                    nativeNodes ++;
+                    return false;
+                }
+            case JitNode::op1:
+                if ( jitIsIncDec(jn.op) ) {
+                    compileValue(node, jn.type);
+                    return false;
+                }
+                break;
+            default:
+                break;
+            }
+            fallbackStatement(node);
+            return true;
+        }
+    };
+
+    bool baselineJitAvailable() {
+        return true;
+    }
+
+    bool baselineJitCompile ( Context & context, const vector<SimFunction *> & functions, vector<JitFunction> & result, TextWriter * log ) {
+        result.clear();
+        result.resize(functions.size(), nullptr);
+        // debugger needs single step nodes, which are the interpreter
+        if ( context.hasDebugger() ) return false;
+        BaselineJitCompiler compiler(context);
+        vector<int32_t> entries(functions.size(), -1);
+        bool any = false;
+        for ( size_t i=0; i!=functions.size(); ++i ) {
+            auto fn = functions[i];
+            if ( !fn || !fn->code || fn->builtin || fn->aot || fn->jit || fn->fastcall || fn->pinvoke ) continue;
+            auto mark = uint32_t(compiler.as.code.size());
+            auto labels = uint32_t(compiler.as.labels.size());
+            auto fixups = uint32_t(compiler.as.fixups.size());
+            if ( compiler.compileFunction(fn) ) {
+                entries[i] = int32_t(mark);
+                any = true;
+                if ( log ) {
+                    *log << fn->mangledName << ": " << compiler.nativeNodes << " native, "
+                        << compiler.fallbackNodes << " interpreted, " << (uint32_t(compiler.as.code.size()) - mark) << " bytes\n";
+                }
+            } else {
+                // nothing to gain, roll back
+                compiler.as.code.resize(mark);
+                compiler.as.labels.resize(labels);
+                compiler.as.fixups.resize(fixups);
+            }
+        }
+        if ( !any || !compiler.as.link() ) return false;
+        if ( !context.baselineJitCode ) context.baselineJitCode = make_shared<BaselineJitCode>();
+        auto code = context.baselineJitCode->commit(compiler.as.code.data(), uint32_t(compiler.as.code.size()));
+        if ( !code ) return false;
+        for ( size_t i=0; i!=functions.size(); ++i ) {
+            if ( entries[i]!=-1 ) result[i] = (JitFunction) (code + entries[i]);
+        }
+        return true;
+    }
+
+#else
+
+    BaselineJitCode::~BaselineJitCode() {
+    }
+
+    char * BaselineJitCode::commit ( const uint8_t *, uint32_t ) {
+        return nullptr;
+    }
+
+    bool baselineJitAvailable() {
+        return false;
+    }
+
+    bool baselineJitCompile ( Context &, const vector<SimFunction *> & functions, vector<JitFunction> & result, TextWriter * ) {
+        result.clear();
+        result.resize(functions.size(), nullptr);
+        return false;
+    }
+
+#endif
+}
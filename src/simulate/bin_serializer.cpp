@@ -16,6 +16,7 @@ namespace das {
         uint32_t bytesAllocated = 0;
         uint32_t bytesWritten = 0;
         uint32_t bytesGrow = 1024;
+        WalkPlanCache plans;
     // writer
         BinDataSerialize ( Context & ctx, LineInfo * at ) {
             DEBUG_BIN_DATA("writing\n");
@@ -42,7 +43,8 @@ namespace das {
         }
         __forceinline void write ( void * data, uint32_t size ) {
             if ( bytesWritten + size > bytesAllocated ) {
-                uint32_t newSize = das::max ( bytesAllocated + bytesGrow, bytesWritten + size );
+                // grows geometrically, otherwise large saves copy the buffer over and over. close trims it
+                uint32_t newSize = das::max ( bytesAllocated + das::max(bytesGrow, bytesAllocated), bytesWritten + size );
                 bytesAt = context->reallocate(bytesAt, bytesAllocated, newSize, debugInfo);
                 context->heap->mark_comment(bytesAt, "binary serializer write");
                 bytesAllocated = newSize;
@@ -93,12 +95,54 @@ namespace das {
                 save(data);
             }
         }
+        __forceinline void serialize_bytes ( char * data, uint32_t size ) {
+            if ( reading ) {
+                read ( data, size );
+            } else {
+                write ( data, size );
+            }
+        }
+        // same stream as walk_struct would produce, but without the virtual call per field
+        void walk_plan ( char * ps, const WalkPlan & plan ) {
+            for ( auto & op : plan.ops ) {
+                char * pf = ps + op.offset;
+                switch ( op.kind ) {
+                    case WalkPlanOp::Kind::bytes:       serialize_bytes(pf, op.size); break;
+                    case WalkPlanOp::Kind::string:      String(*(char **)pf); break;
+                    case WalkPlanOp::Kind::structure:   verify_hash(op.structInfo->hash); break;
+                    case WalkPlanOp::Kind::enumeration: verify_hash(op.enumInfo->hash); serialize_bytes(pf, op.size); break;
+                    case WalkPlanOp::Kind::walk:        walk(pf, op.typeInfo); break;
+                }
+                if ( cancel() ) return;
+            }
+        }
         void close () {
             if ( !reading && bytesAt ) {
                 DEBUG_BIN_DATA("close at %i bytes\n\n", bytesWritten);
                 bytesAt = context->reallocate(bytesAt, bytesAllocated, bytesWritten, debugInfo);
             }
         }
+    // walk
+        using DataWalker::walk;
+        virtual void walk ( char * pa, TypeInfo * info ) override {
+            if ( pa && canUseWalkPlan(info) ) {
+                walk_plan(pa, *plans.get(info->structType));
+            } else {
+                DataWalker::walk(pa, info);
+            }
+        }
+        virtual void walk_array ( char * pa, uint32_t stride, uint32_t count, TypeInfo * ti ) override {
+            if ( isPlainWalkData(ti) && stride==ti->size ) {
+                if ( count ) serialize_bytes(pa, stride * count);
+            } else if ( canUseWalkPlan(ti) ) {
+                auto plan = plans.get(ti->structType);
+                for ( uint32_t i=0; i!=count && !cancel(); ++i ) {
+                    walk_plan(pa + size_t(i)*stride, *plan);
+                }
+            } else {
+                DataWalker::walk_array(pa, stride, count, ti);
+            }
+        }
     // data structures
         virtual void beforeStructure ( char *, StructInfo * si ) override {
             verify_hash(si->hash);
@@ -294,4 +294,103 @@ namespace das {
             }
         }
     }
+
+    bool isPlainWalkData ( TypeInfo * ti ) {
+        if ( (ti->flags & TypeInfo::flag_ref) || ti->dimSize ) return false;
+        switch ( ti->type ) {
+            case Type::tBool:       case Type::tInt8:       case Type::tUInt8:
+            case Type::tInt16:      case Type::tUInt16:     case Type::tInt64:      case Type::tUInt64:
+            case Type::tInt:        case Type::tInt2:       case Type::tInt3:       case Type::tInt4:
+            case Type::tUInt:       case Type::tUInt2:      case Type::tUInt3:      case Type::tUInt4:
+            case Type::tFloat:      case Type::tFloat2:     case Type::tFloat3:     case Type::tFloat4:
+            case Type::tDouble:     case Type::tBitfield:
+            case Type::tRange:      case Type::tURange:     case Type::tRange64:    case Type::tURange64:
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    bool canUseWalkPlan ( TypeInfo * ti ) {
+        if ( (ti->flags & TypeInfo::flag_ref) || ti->dimSize || ti->type!=Type::tStructure ) return false;
+        return !(ti->structType->flags & (StructInfo::flag_class | StructInfo::flag_lambda));
+    }
+
+    void WalkPlan::compile ( StructInfo * si ) {
+        ops.clear();
+        gcOps.clear();
+        hasGcWalk = false;
+        addStructure(si, 0);
+        for ( auto & op : ops ) {
+            if ( op.kind==WalkPlanOp::Kind::string ) {
+                gcOps.push_back(op);
+            } else if ( op.kind==WalkPlanOp::Kind::walk && (op.typeInfo->flags & (TypeInfo::flag_heapGC | TypeInfo::flag_stringHeapGC)) ) {
+                gcOps.push_back(op);
+                hasGcWalk = true;
+            }
+        }
+    }
+
+    void WalkPlan::addStructure ( StructInfo * si, uint32_t offset ) {
+        WalkPlanOp op;
+        op.kind = WalkPlanOp::Kind::structure;
+        op.offset = offset;
+        op.size = si->size;
+        op.structInfo = si;
+        ops.push_back(op);
+        for ( uint32_t i=0, is=si->count; i!=is; ++i ) {
+            VarInfo * vi = si->fields[i];
+            addField(vi, offset + vi->offset);
+        }
+    }
+
+    void WalkPlan::addBytes ( uint32_t offset, uint32_t size ) {
+        if ( !ops.empty() ) {
+            auto & last = ops.back();
+            if ( last.kind==WalkPlanOp::Kind::bytes && last.offset+last.size==offset ) {
+                last.size += size;
+                return;
+            }
+        }
+        WalkPlanOp op;
+        op.kind = WalkPlanOp::Kind::bytes;
+        op.offset = offset;
+        op.size = size;
+        op.typeInfo = nullptr;
+        ops.push_back(op);
+    }
+
+    void WalkPlan::addField ( TypeInfo * ti, uint32_t offset ) {
+        WalkPlanOp op;
+        op.offset = offset;
+        op.size = ti->size;
+        if ( isPlainWalkData(ti) ) {
+            addBytes(offset, ti->size);
+            return;
+        } else if ( canUseWalkPlan(ti) ) {
+            addStructure(ti->structType, offset);
+            return;
+        } else if ( !(ti->flags & TypeInfo::flag_ref) && !ti->dimSize && ti->type==Type::tString ) {
+            op.kind = WalkPlanOp::Kind::string;
+            op.typeInfo = ti;
+        } else if ( !(ti->flags & TypeInfo::flag_ref) && !ti->dimSize
+                && (ti->type==Type::tEnumeration || ti->type==Type::tEnumeration8 || ti->type==Type::tEnumeration16) ) {
+            op.kind = WalkPlanOp::Kind::enumeration;
+            op.enumInfo = ti->enumType;
+        } else {
+            op.kind = WalkPlanOp::Kind::walk;
+            op.typeInfo = ti;
+        }
+        ops.push_back(op);
+    }
+
+    const WalkPlan * WalkPlanCache::get ( StructInfo * si ) {
+        auto it = plans.find(si);
+        if ( it!=plans.end() ) return it->second;
+        auto plan = new WalkPlan();
+        storage.emplace_back(plan);
+        plan->compile(si);
+        plans[si] = plan;
+        return plan;
+    }
 }
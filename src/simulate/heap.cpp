@@ -16,6 +16,20 @@ namespace das {
 #endif
 
     char * AnyHeapAllocator::impl_allocateIterator ( uint32_t size, const char * name, const LineInfo * info ) {
+        // pooled sizes are rounded up, so that any iterator of the same size class fits
+        uint32_t si = (size + 15) >> 4;
+        if ( si && si<=iteratorPoolSizes ) {
+            size = si << 4;
+            if ( char * data = iteratorPool[si-1] ) {
+                iteratorPool[si-1] = *((char **)(data + 16));
+                iteratorPoolCount[si-1] --;
+                iteratorPoolBytes -= size + 16;
+                iteratorPoolHits ++;
+                mark_comment(data, name);
+                if ( info ) mark_location(data,info);
+                return (data + 16);
+            }
+        }
         char * data = impl_allocate(size + 16);
         if ( !data ) return nullptr;
         *((uint32_t *)data) = size;
@@ -27,9 +41,35 @@ namespace das {
     void AnyHeapAllocator::impl_freeIterator ( char * ptr ) {
         ptr -= 16;
         uint32_t size = *((uint32_t *)ptr);
+        uint32_t si = size >> 4;
+        if ( !(size & 15) && si && si<=iteratorPoolSizes && iteratorPoolCount[si-1]<iteratorPoolDepth ) {
+            *((char **)(ptr + 16)) = iteratorPool[si-1];
+            iteratorPool[si-1] = ptr;
+            iteratorPoolCount[si-1] ++;
+            iteratorPoolBytes += size + 16;
+            return;
+        }
         impl_free(ptr, size + 16);
     }
 
+    void AnyHeapAllocator::flushIteratorPool() {
+        for ( uint32_t si=0; si!=iteratorPoolSizes; ++si ) {
+            while ( char * data = iteratorPool[si] ) {
+                iteratorPool[si] = *((char **)(data + 16));
+                impl_free(data, ((si+1) << 4) + 16);
+            }
+        }
+        dropIteratorPool();
+    }
+
+    void AnyHeapAllocator::dropIteratorPool() {
+        for ( uint32_t si=0; si!=iteratorPoolSizes; ++si ) {
+            iteratorPool[si] = nullptr;
+            iteratorPoolCount[si] = 0;
+        }
+        iteratorPoolBytes = 0;
+    }
+
     char * AnyHeapAllocator::allocateName ( const string & name ) {
         if (!name.empty()) {
             auto length = uint32_t(name.length());
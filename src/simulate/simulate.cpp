@@ -4,6 +4,8 @@
 #include "daScript/simulate/simulate_nodes.h"
 #include "daScript/simulate/runtime_string.h"
 #include "daScript/simulate/debug_print.h"
+#include "daScript/simulate/alloc_profiler.h"
+#include "daScript/simulate/tier_up.h"
 #include "daScript/misc/fpe.h"
 #include "daScript/misc/debug_break.h"
 #include "daScript/ast/ast.h"
@@ -655,6 +657,7 @@ namespace das
         DAS_PROFILE_NODE
         SimNode ** __restrict tail = list + total;
         while ( cond->evalBool(context) && !context.stopFlags ) {
+            DAS_COUNT_BACKEDGES(1)
             SimNode ** __restrict body = list;
         loopbegin:;
             for (; body!=tail; ++body) {
@@ -966,6 +969,7 @@ namespace das
                 << ", depth = " << debugInfo->depth() << "\n";
             bytesTotal += debugInfo->totalAlignedMemoryAllocated();
             bytesUsed += debugInfo->bytesAllocated();
+            if ( lazyDebugInfo ) lazyDebugInfo->logMemInfo(tw);
         }
     // stack
         if ( stack.bottom() ) {
@@ -1008,6 +1012,7 @@ namespace das
         code = ctx.code;
         constStringHeap = ctx.constStringHeap;
         debugInfo = ctx.debugInfo;
+        lazyDebugInfo = ctx.lazyDebugInfo;
         thisProgram = ctx.thisProgram;
         thisHelper = ctx.thisHelper;
         category.value = ctx.category.value;
@@ -1033,6 +1038,8 @@ namespace das
         tabMnLookup = ctx.tabMnLookup;
         tabGMnLookup = ctx.tabGMnLookup;
         tabAdLookup = ctx.tabAdLookup;
+        // native code of the baseline jit
+        baselineJitCode = ctx.baselineJitCode;
         // lockcheck
         skipLockChecks = ctx.skipLockChecks;
     }
@@ -1061,6 +1068,7 @@ namespace das
         code = ctx.code;
         constStringHeap = ctx.constStringHeap;
         debugInfo = ctx.debugInfo;
+        lazyDebugInfo = ctx.lazyDebugInfo;
         thisProgram = ctx.thisProgram;
         thisHelper = ctx.thisHelper;
         name = "clone of " + ctx.name;
@@ -1079,6 +1087,8 @@ namespace das
         stringHeap->setInitialSize(ctx.stringHeap->getInitialSize());
         stringHeap->setIntern(ctx.stringHeap->isIntern());
         stringHeap->setLimit(ctx.stringHeap->getLimit());
+        if ( ctx.heap->isTelemetryEnabled() ) heap->setTelemetryEnabled(true);
+        if ( ctx.stringHeap->isTelemetryEnabled() ) stringHeap->setTelemetryEnabled(true);
         // globals
         annotationData = ctx.annotationData;
         globalsSize = ctx.globalsSize;
@@ -1101,6 +1111,8 @@ namespace das
         tabMnLookup = ctx.tabMnLookup;
         tabGMnLookup = ctx.tabGMnLookup;
         tabAdLookup = ctx.tabAdLookup;
+        // native code of the baseline jit
+        baselineJitCode = ctx.baselineJitCode;
         // lockcheck
         skipLockChecks = ctx.skipLockChecks;
         // threadlock_context
@@ -1129,6 +1141,11 @@ namespace das
     }
 
     Context::~Context() {
+        // background compiler reads our functions, stop it first
+        if ( tierUp ) {
+            delete tierUp;
+            tierUp = nullptr;
+        }
         if ( !failed ) {
             on_debug_agent_mutex([&](){
                 // unregister
@@ -1153,6 +1170,11 @@ namespace das
             delete contextMutex;
             contextMutex = nullptr;
         }
+        // and allocation profiler
+        if ( allocProfiler ) {
+            delete allocProfiler;
+            allocProfiler = nullptr;
+        }
     }
 
     struct SimNodeRelocator : SimVisitor {
@@ -1182,7 +1204,7 @@ namespace das
         SimFunction * oldFunctions = functions;
         if ( totalFunctions ) {
             SimFunction * newFunctions = (SimFunction *) rel.newCode->allocate(totalFunctions*sizeof(SimFunction));
-            memcpy ( newFunctions, functions, totalFunctions*sizeof(SimFunction));
+            memcpy ( (void *) newFunctions, (void *) functions, totalFunctions*sizeof(SimFunction));
             for ( int i=0, is=totalFunctions; i!=is; ++i ) {
                 newFunctions[i].name = rel.newCode->allocateName(functions[i].name);
                 newFunctions[i].mangledName = rel.newCode->allocateName(functions[i].mangledName);
@@ -1260,6 +1282,31 @@ namespace das
         }
     };
 
+    // snapshot is only good when init script did not allocate, otherwise globals point to the heap which is about to be reset
+    bool Context::snapshotGlobals ( vector<char> & snapshot ) const {
+        if ( !globals || heap->bytesAllocated() || stringHeap->bytesAllocated() ) return false;
+        snapshot.resize(globalsSize);
+        memcpy(snapshot.data(), globals, globalsSize);
+        return true;
+    }
+
+    // makes clone good for the next job. heaps are reset, and globals are restored from the snapshot or reinitialized
+    void Context::recycle ( const vector<char> * globalsSnapshot ) {
+        restart();
+        restartHeaps();
+        if ( globalsSnapshot ) {
+            memcpy(globals, globalsSnapshot->data(), globalsSize);
+        } else if ( stack.size() > globalInitStackSize ) {
+            runInitScript();
+        } else {
+            auto ssz = max ( int(stack.size()), 16384 ) + globalInitStackSize;
+            StackAllocator init_stack(ssz);
+            SharedStackGuard init_guard(*this, init_stack);
+            runInitScript();
+        }
+        restart();
+    }
+
     void Context::runInitScript ( ) {
         DAS_ASSERTF(insideContext==0,"can't run init script on the locked context");
         char * EP, *SP;
@@ -1920,30 +1967,39 @@ namespace das
     }
 
     void Context::onAllocateString ( void * ptr, uint64_t size, const LineInfo & at ) {
+        if ( allocProfiler ) allocProfiler->onAllocate(this, ptr, size, at);
         if ( g_envTotal > 0 && daScriptEnvironment::bound && daScriptEnvironment::bound->g_threadLocalDebugAgent.debugAgent ) {
             daScriptEnvironment::bound->g_threadLocalDebugAgent.debugAgent->onAllocateString(this, ptr, size, at);
         }
     }
 
     void Context::onFreeString ( void * ptr, const LineInfo & at ) {
+        if ( allocProfiler ) allocProfiler->onFree(ptr);
         if ( g_envTotal > 0 && daScriptEnvironment::bound && daScriptEnvironment::bound->g_threadLocalDebugAgent.debugAgent ) {
             daScriptEnvironment::bound->g_threadLocalDebugAgent.debugAgent->onFreeString(this, ptr, at);
         }
     }
 
     void Context::onAllocate ( void * ptr, uint64_t size, const LineInfo & at ) {
+        if ( allocProfiler ) allocProfiler->onAllocate(this, ptr, size, at);
         if ( g_envTotal > 0 && daScriptEnvironment::bound && daScriptEnvironment::bound->g_threadLocalDebugAgent.debugAgent ) {
             daScriptEnvironment::bound->g_threadLocalDebugAgent.debugAgent->onAllocate(this, ptr, size, at);
         }
     }
 
     void Context::onReallocate ( void * ptr, uint64_t size, void * newPtr, uint64_t newSize, const LineInfo & at ) {
+        if ( allocProfiler ) allocProfiler->onReallocate(this, ptr, newPtr, newSize, at);
         if ( g_envTotal > 0 && daScriptEnvironment::bound && daScriptEnvironment::bound->g_threadLocalDebugAgent.debugAgent ) {
             daScriptEnvironment::bound->g_threadLocalDebugAgent.debugAgent->onReallocate(this, ptr, size, newPtr, newSize, at);
         }
     }
 
+    void Context::onHeapsReset() {
+        if ( allocProfiler ) allocProfiler->onHeapsReset();
+    }
+
     void Context::onFree ( void * ptr, const LineInfo & at ) {
+        if ( allocProfiler ) allocProfiler->onFree(ptr);
         if ( g_envTotal > 0 && daScriptEnvironment::bound && daScriptEnvironment::bound->g_threadLocalDebugAgent.debugAgent ) {
             daScriptEnvironment::bound->g_threadLocalDebugAgent.debugAgent->onFree(this, ptr, at);
         }
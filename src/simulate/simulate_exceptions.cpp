@@ -100,6 +100,7 @@ namespace das {
         auto atba = abiThisBlockArg;
         char * EP, * SP;
         stack.watermark(EP,SP);
+        auto lbe = loopBackedges;   // longjmp skips DAS_TIER_LEAVE of the unwound calls
         vec4f vres = v_zero();
 #if DAS_ENABLE_EXCEPTIONS
         try {
@@ -108,6 +109,7 @@ namespace das {
             abiArg = aa;
             abiCMRES = acm;
             abiThisBlockArg = atba;
+            loopBackedges = lbe;
             stack.pop(EP,SP);
             exceptionMessage = ex.what();
             exception = exceptionMessage.c_str();
@@ -123,6 +125,7 @@ namespace das {
             abiArg = aa;
             abiCMRES = acm;
             abiThisBlockArg = atba;
+            loopBackedges = lbe;
             stack.pop(EP,SP);
         }
         throwBuf = JB;
@@ -136,6 +139,7 @@ namespace das {
         auto atba = abiThisBlockArg;
         char * EP, * SP;
         stack.watermark(EP,SP);
+        auto lbe = loopBackedges;   // longjmp skips DAS_TIER_LEAVE of the unwound calls
         bool bres = false;
 #if DAS_ENABLE_EXCEPTIONS
         try {
@@ -145,6 +149,7 @@ namespace das {
             abiArg = aa;
             abiCMRES = acm;
             abiThisBlockArg = atba;
+            loopBackedges = lbe;
             stack.pop(EP,SP);
             exceptionMessage = ex.what();
             exception = exceptionMessage.c_str();
@@ -161,6 +166,7 @@ namespace das {
             abiArg = aa;
             abiCMRES = acm;
             abiThisBlockArg = atba;
+            loopBackedges = lbe;
             stack.pop(EP,SP);
         }
         throwBuf = JB;
@@ -174,6 +180,7 @@ namespace das {
         auto atba = abiThisBlockArg;
         char * EP, * SP;
         stack.watermark(EP,SP);
+        auto lbe = loopBackedges;   // longjmp skips DAS_TIER_LEAVE of the unwound calls
         vec4f vres = v_zero();
 #if DAS_ENABLE_EXCEPTIONS
         try {
@@ -182,6 +189,7 @@ namespace das {
             abiArg = aa;
             abiCMRES = acm;
             abiThisBlockArg = atba;
+            loopBackedges = lbe;
             stack.pop(EP,SP);
             exceptionMessage = ex.what();
             exception = exceptionMessage.c_str();
@@ -197,6 +205,7 @@ namespace das {
             abiArg = aa;
             abiCMRES = acm;
             abiThisBlockArg = atba;
+            loopBackedges = lbe;
             stack.pop(EP,SP);
         }
         throwBuf = JB;
@@ -204,6 +213,52 @@ namespace das {
         return vres;
     }
 
+    int32_t WIN_EH_NO_ASAN Context::evalBatchWithCatch ( SimFunction * fnPtr, vec4f * args, int32_t argStride, int32_t count, vec4f * results ) {
+        // results are vec4f, there is nowhere to put cmres values. this is reachable from the C API, so it is not an assert
+        if ( fnPtr->cmres ) {
+            exceptionMessage = "batch evaluation of functions, which return via cmres, is not supported";
+            exception = exceptionMessage.c_str();
+            exceptionAt = LineInfo();
+            return -1;
+        }
+        auto aa = abiArg;
+        auto acm = abiCMRES;
+        auto atba = abiThisBlockArg;
+        char * EP, * SP;
+        stack.watermark(EP,SP);
+        auto lbe = loopBackedges;   // longjmp skips DAS_TIER_LEAVE of the unwound calls
+        volatile int32_t done = 0;
+#if DAS_ENABLE_EXCEPTIONS
+        try {
+            callBatch(fnPtr, args, argStride, count, results, done, 0);
+        } catch ( const dasException & ex ) {
+            abiArg = aa;
+            abiCMRES = acm;
+            abiThisBlockArg = atba;
+            loopBackedges = lbe;
+            stack.pop(EP,SP);
+            exceptionMessage = ex.what();
+            exception = exceptionMessage.c_str();
+            exceptionAt = ex.exceptionAt;
+        }
+#else
+        jmp_buf ev;
+        jmp_buf * JB = throwBuf;
+        throwBuf = &ev;
+        if ( !setjmp(ev) ) {
+            callBatch(fnPtr, args, argStride, count, results, done, 0);
+        } else {
+            abiArg = aa;
+            abiCMRES = acm;
+            abiThisBlockArg = atba;
+            loopBackedges = lbe;
+            stack.pop(EP,SP);
+        }
+        throwBuf = JB;
+#endif
+        return done;
+    }
+
     // SimNode_TryCatch
 
     vec4f WIN_EH_NO_ASAN SimNode_TryCatch::eval ( Context & context ) {
@@ -211,12 +266,14 @@ namespace das {
         auto aa = context.abiArg; auto acm = context.abiCMRES;
         char * EP, * SP;
         context.stack.watermark(EP,SP);
+        auto lbe = context.loopBackedges;   // longjmp skips DAS_TIER_LEAVE of the unwound calls
         #if DAS_ENABLE_EXCEPTIONS
             try {
                 try_block->eval(context);
             } catch ( const dasException & ) {
                 context.abiArg = aa;
                 context.abiCMRES = acm;
+                context.loopBackedges = lbe;
                 context.stack.pop(EP,SP);
                 context.stopFlags = 0;
                 context.last_exception = context.exception;
@@ -233,6 +290,7 @@ namespace das {
                 context.throwBuf = JB;
                 context.abiArg = aa;
                 context.abiCMRES = acm;
+                context.loopBackedges = lbe;
                 context.stack.pop(EP,SP);
                 context.stopFlags = 0;
                 context.last_exception = context.exception;
@@ -250,6 +308,7 @@ namespace das {
         auto aa = context.abiArg; auto acm = context.abiCMRES;
         char * EP, * SP;
         context.stack.watermark(EP,SP);
+        auto lbe = context.loopBackedges;   // longjmp skips DAS_TIER_LEAVE of the unwound calls
         #if DAS_ENABLE_EXCEPTIONS
             try {
                 DAS_SINGLE_STEP(context,try_block->debugInfo,false);
@@ -257,6 +316,7 @@ namespace das {
             } catch ( const dasException & ) {
                 context.abiArg = aa;
                 context.abiCMRES = acm;
+                context.loopBackedges = lbe;
                 context.stack.pop(EP,SP);
                 context.stopFlags = 0;
                 context.last_exception = context.exception;
@@ -275,6 +335,7 @@ namespace das {
                 context.throwBuf = JB;
                 context.abiArg = aa;
                 context.abiCMRES = acm;
+                context.loopBackedges = lbe;
                 context.stack.pop(EP,SP);
                 context.stopFlags = 0;
                 context.last_exception = context.exception;
@@ -292,6 +353,7 @@ namespace das {
         auto aa = __context__->abiArg; auto acm = __context__->abiCMRES;
         char * EP, * SP;
         __context__->stack.watermark(EP,SP);
+        auto lbe = __context__->loopBackedges;   // longjmp skips DAS_TIER_LEAVE of the unwound calls
 #if DAS_ENABLE_EXCEPTIONS
         try {
             try_block();
@@ -299,6 +361,7 @@ namespace das {
             catch_block();
             __context__->abiArg = aa;
             __context__->abiCMRES = acm;
+            __context__->loopBackedges = lbe;
             __context__->stack.pop(EP,SP);
             __context__->stopFlags = 0;
             __context__->last_exception = __context__->exception;
@@ -315,6 +378,7 @@ namespace das {
             __context__->throwBuf = JB;
             __context__->abiArg = aa;
             __context__->abiCMRES = acm;
+            __context__->loopBackedges = lbe;
             __context__->stack.pop(EP,SP);
             __context__->stopFlags = 0;
             __context__->last_exception = __context__->exception;
@@ -328,12 +392,14 @@ namespace das {
         auto aa = context->abiArg; auto acm = context->abiCMRES;
         char * EP, * SP;
         context->stack.watermark(EP,SP);
+        auto lbe = context->loopBackedges;   // longjmp skips DAS_TIER_LEAVE of the unwound calls
         #if DAS_ENABLE_EXCEPTIONS
             try {
                 context->invoke(try_block, nullptr, nullptr, at);
             } catch ( const dasException & ) {
                 context->abiArg = aa;
                 context->abiCMRES = acm;
+                context->loopBackedges = lbe;
                 context->stack.pop(EP,SP);
                 context->stopFlags = 0;
                 context->last_exception = context->exception;
@@ -350,6 +416,7 @@ namespace das {
                 context->throwBuf = JB;
                 context->abiArg = aa;
                 context->abiCMRES = acm;
+                context->loopBackedges = lbe;
                 context->stack.pop(EP,SP);
                 context->stopFlags = 0;
                 context->last_exception = context->exception;
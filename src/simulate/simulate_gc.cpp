@@ -4,6 +4,7 @@
 #include "daScript/simulate/simulate.h"
 #include "daScript/simulate/data_walker.h"
 #include "daScript/simulate/debug_print.h"
+#include "daScript/simulate/alloc_profiler.h"
 
 namespace das
 {
@@ -642,6 +643,7 @@ namespace das
     void Context::reportAnyHeap(LineInfo * at, bool sth, bool rgh, bool rghOnly, bool errorsOnly) {
         LOG tp(LogLevel::debug);
         // now
+        heap->flushIteratorPool();     // otherwise pooled iterators are reported as leaks
         HeapReporter walker;
         walker.context = this;
         walker.reportStringHeap = sth;
@@ -693,10 +695,10 @@ namespace das
                 intptr_t iblock = intptr_t(pp->block);
                 if ( iblock & 1 ) {
                     block = (Block *) (iblock & ~1);
-                    info = block->info;
+                    info = requireDebugInfo(block->info);
                     SP = stack.bottom() + block->stackOffset;
                 } else {
-                    info = pp->info;
+                    info = requireDebugInfo(pp->info);
                 }
                 tp << "FUNCTION " << info->name << "\n";
             }
@@ -740,6 +742,7 @@ namespace das
         vector<PtrRange>    ptrRangeStack;
         PtrRange            currentRange;
         das_set<char *>     failed;
+        WalkPlanCache       plans;
         bool                markStringHeap = true;
         bool                validate = false;
         void prepare() {
@@ -876,6 +879,32 @@ namespace das
             markAndPushRange(PtrRange(ptr, size+16));
         }
 
+        // elements are within the array data, which is already marked. so only strings and fields which reference the heap are visited
+        virtual void walk_array ( char * pa, uint32_t stride, uint32_t count, TypeInfo * ti ) override {
+            if ( !canVisitArrayData(ti,count) ) return;
+            if ( !canUseWalkPlan(ti) ) {
+                BaseGcDataWalker::walk_array(pa, stride, count, ti);
+                return;
+            }
+            auto si = ti->structType;
+            auto plan = plans.get(si);
+            char * pe = pa;
+            for ( uint32_t i=0; i!=count; ++i, pe+=stride ) {
+                if ( plan->hasGcWalk ) {
+                    if ( !canVisitStructure(pe, si) ) continue;
+                    visited.emplace_back(make_pair(pe,si->hash));
+                }
+                for ( auto & op : plan->gcOps ) {
+                    if ( op.kind==WalkPlanOp::Kind::string ) {
+                        String(*(char **)(pe + op.offset));
+                    } else if ( op.typeInfo->flags & gcFlags ) {
+                        walk(pe + op.offset, op.typeInfo);
+                    }
+                }
+                if ( plan->hasGcWalk ) visited.pop_back();
+            }
+        }
+
         using DataWalker::walk;
 
         virtual void walk ( char * pa, TypeInfo * info ) override {
@@ -980,6 +1009,9 @@ namespace das
         GcGuard guard(this);
         // clean up, so that all small allocations are marked as 'free'
         stringDisposeQue = nullptr;
+        uint64_t stringHeapBefore = stringHeap->bytesAllocated();
+        heap->flushIteratorPool();     // pooled iterators are not reachable, so sweep would free them
+        uint64_t heapBefore = heap->bytesAllocated();
         if ( sheap && !stringHeap->mark() ) return;
         if ( !heap->mark() ) return;
         // now
@@ -1025,10 +1057,10 @@ namespace das
                 intptr_t iblock = intptr_t(pp->block);
                 if ( iblock & 1 ) {
                     block = (Block *) (iblock & ~1);
-                    info = block->info;
+                    info = requireDebugInfo(block->info);
                     SP = stack.bottom() + block->stackOffset;
                 } else {
-                    info = pp->info;
+                    info = requireDebugInfo(pp->info);
                 }
             }
             if ( info ) {
@@ -1058,9 +1090,14 @@ namespace das
             sp += info ? info->stackSize : pp->stackSize;
         }
         // sweep
-        if ( sheap ) stringHeap->sweep();
-        // report errors
+        if ( sheap ) {
+            stringHeap->sweep();
+            stringHeap->onCollected(stringHeapBefore);
+        }
         heap->sweep();
+        heap->onCollected(heapBefore);
+        if ( allocProfiler ) allocProfiler->onCollected(this);
+        // report errors
         if ( !walker.failed.empty() ) {
             reportAnyHeap(at, sheap, true, true, true);
             TextWriter tw;
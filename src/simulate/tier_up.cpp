@@ -0,0 +1,133 @@
+#include "daScript/misc/platform.h"
+
+#include "daScript/simulate/tier_up.h"
+#include "daScript/simulate/baseline_jit.h"
+#include "daScript/simulate/runtime_string.h"
+#include "daScript/simulate/aot_builtin_jit.h"
+
+namespace das {
+
+    TierUpService::TierUpService ( Context & ctx, uint64_t calls, uint64_t loops, uint32_t interval )
+        : context(ctx), callThreshold(calls), loopThreshold(loops), intervalMs(das::max(interval, 1u)) {
+        tiers.resize(context.getTotalFunctions(), Tier::interpreted);
+        bool available = baselineJitAvailable() && !context.hasDebugger();
+        for ( int32_t fni=0, fnis=context.getTotalFunctions(); fni!=fnis; ++fni ) {
+            auto fn = context.getFunction(fni);
+            if ( fn->aot || fn->jit ) {
+                tiers[fni] = Tier::native;
+            } else if ( !available || !fn->code || fn->builtin || fn->fastcall || fn->pinvoke ) {
+                tiers[fni] = Tier::rejected;
+            }
+        }
+        // worker never touches the shared pointer itself, only the code it points to
+        if ( !context.baselineJitCode ) context.baselineJitCode = make_shared<BaselineJitCode>();
+        if ( available ) worker = std::thread([this](){ run(); });
+    }
+
+    TierUpService::~TierUpService() {
+        {
+            lock_guard<mutex> guard(lock);
+            stopping = true;
+        }
+        wake.notify_all();
+        if ( worker.joinable() ) worker.join();
+    }
+
+    void TierUpService::run() {
+        for ( ;; ) {
+            {
+                unique_lock<mutex> guard(lock);
+                wake.wait_for(guard, std::chrono::milliseconds(intervalMs), [&](){ return stopping.load(); });
+                if ( stopping ) return;
+            }
+            scan();
+        }
+    }
+
+    void TierUpService::scan() {
+        // only this thread moves functions out of the interpreted tier, so tiers are not locked while compiling
+        vector<SimFunction *> hot;
+        vector<int32_t> hotIndex;
+        for ( int32_t fni=0, fnis=int32_t(tiers.size()); fni!=fnis; ++fni ) {
+            if ( tiers[fni]!=Tier::interpreted ) continue;
+            auto fn = context.getFunction(fni);
+            if ( fn->getCallCount()>=callThreshold || fn->getLoopCount()>=loopThreshold ) {
+                hot.push_back(fn);
+                hotIndex.push_back(fni);
+            }
+        }
+        if ( hot.empty() ) return;
+        vector<JitFunction> code;
+        {
+            lock_guard<mutex> codeGuard(codeLock);
+            baselineJitCompile(context, hot, code);
+        }
+        lock_guard<mutex> guard(lock);
+        for ( size_t i=0; i!=hot.size(); ++i ) {
+            if ( code[i] ) {
+                tiers[hotIndex[i]] = Tier::compiled;
+                ready.emplace_back(hotIndex[i], code[i]);
+            } else {
+                tiers[hotIndex[i]] = Tier::rejected;
+            }
+        }
+    }
+
+    int32_t TierUpService::safePoint() {
+        // compiler is busy, context thread does not wait for it. whatever is ready is installed next time
+        unique_lock<mutex> codeGuard(codeLock, std::try_to_lock);
+        if ( !codeGuard.owns_lock() ) return 0;
+        lock_guard<mutex> guard(lock);
+        int32_t installed = 0;
+        for ( auto & rc : ready ) {
+            auto fn = context.getFunction(rc.first);
+            if ( das_install_jit((void *)rc.second, Func(fn), context) ) {
+                tiers[rc.first] = Tier::promoted;
+                installed ++;
+            } else {
+                tiers[rc.first] = Tier::rejected;
+            }
+        }
+        ready.clear();
+        totalPromoted += installed;
+        return installed;
+    }
+
+    void TierUpService::reportJson ( TextWriter & tw, int32_t maxFunctions ) const {
+        static const char * tierNames[] = { "interpreted", "native", "compiled", "promoted", "rejected" };
+        struct Hot {
+            int32_t     index;
+            uint64_t    calls;
+            uint64_t    loops;
+        };
+        vector<Hot> order;
+        vector<Tier> snapshot;
+        uint64_t promoted = 0;
+        {
+            lock_guard<mutex> guard(lock);
+            snapshot = tiers;
+            promoted = totalPromoted;
+        }
+        // counters keep changing, sort the snapshot
+        for ( int32_t fni=0, fnis=int32_t(snapshot.size()); fni!=fnis; ++fni ) {
+            auto fn = context.getFunction(fni);
+            Hot hot = { fni, fn->getCallCount(), fn->getLoopCount() };
+            if ( hot.calls || hot.loops ) order.push_back(hot);
+        }
+        // hottest first, loop iterations weighted same as calls
+        sort(order.begin(), order.end(), [&](const Hot & a, const Hot & b){
+            return a.calls + a.loops > b.calls + b.loops;
+        });
+        if ( maxFunctions>=0 && int32_t(order.size())>maxFunctions ) order.resize(maxFunctions);
+        tw << "{\"callThreshold\":" << callThreshold << ",\"loopThreshold\":" << loopThreshold
+            << ",\"promoted\":" << promoted << ",\"functions\":[";
+        for ( size_t i=0; i!=order.size(); ++i ) {
+            auto fn = context.getFunction(order[i].index);
+            if ( i ) tw << ",";
+            tw << "{\"function\":\"" << escapeString(fn->mangledName, false) << "\""
+                << ",\"calls\":" << order[i].calls << ",\"loops\":" << order[i].loops
+                << ",\"tier\":\"" << tierNames[int32_t(snapshot[order[i].index])] << "\"}";
+        }
+        tw << "]}";
+    }
+}
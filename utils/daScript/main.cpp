@@ -1,5 +1,6 @@
 #include "daScript/daScript.h"
 #include "daScript/simulate/fs_file_info.h"
+#include "daScript/ast/ast_aot_live.h"
 #include <filesystem>
 #include <string_view>
 using namespace das;
@@ -18,6 +19,8 @@ static bool pauseAfterErrors = false;
 static bool quiet = false;
 static bool paranoid_validation = false;
 static bool jitEnabled = false;
+static bool astArenaEnabled = false;
+static string liveAotDir;
 
 das::Context* get_context(int stackSize = 0);
 #ifdef _WIN32
@@ -491,6 +494,7 @@ bool compile_and_run(const string& fn, const string& mainFnName, bool outputProg
 		policies.jit = true;
 		policies.jit_module = getDasRoot() + "/daslib/just_in_time.das";
 	}
+	policies.ast_arena = astArenaEnabled;
 	policies.fail_on_no_aot = false;
 	policies.fail_on_lack_of_aot_export = false;
 	if (auto program = compileDaScript(fn, access, tout, dummyGroup, policies)) {
@@ -516,6 +520,15 @@ bool compile_and_run(const string& fn, const string& mainFnName, bool outputProg
 				success = true;
 				tout << "dry run: " << fn << "\n";
 			} else {
+				// background compiler keeps going after main is done, so that the next run finds the library in the cache.
+				// LiveAot does not wait for it on exit, the compiler renames the library into the cache on its own
+				unique_ptr<LiveAot> liveAot;
+				if (!liveAotDir.empty() && !debuggerRequired) {
+					LiveAotOptions liveAotOptions;
+					liveAotOptions.cacheDir = liveAotDir;
+					liveAot = make_unique<LiveAot>(liveAotOptions);
+					liveAot->start(program, *pctx, tout);
+				}
 				auto fnVec = pctx->findFunctions(mainFnName.c_str());
 				das::vector<SimFunction*> fnMVec;
 				for (auto fnAS : fnVec) {
@@ -534,6 +547,9 @@ bool compile_and_run(const string& fn, const string& mainFnName, bool outputProg
 					success = true;
 					auto fnTest = fnMVec.back();
 					pctx->restart();
+					if (liveAot) {
+						liveAot->poll(*pctx, tout);	// links, if compiler is already done
+					}
 					if (debuggerRequired) {
 						pctx->eval(fnTest, nullptr);
 					} else {
@@ -565,6 +581,8 @@ void print_help() {
 		<< "    -pause      pause after errors and pause again before exiting program\n"
 		<< "    -dry-run    compile and simulate script without execution\n"
 		<< "    -dasroot    set path to dascript root folder (with daslib)\n"
+		<< "    -ast-arena  allocate AST nodes from per-program arena (requires DAS_AST_ARENA build)\n"
+		<< "    -aot-live <cache_dir> build AOT library with the system compiler in the background, and cache it\n"
 		<< "daScript -aot <in_script.das> <out_script.das.cpp> {-q} {-p}\n"
 		<< "    -project <path.das_project> path to project file\n"
 		<< "    -p          paranoid validation of CPP AOT\n"
@@ -644,6 +662,22 @@ int MAIN_FUNC_NAME(int argc, char* argv[]) {
 				i += 1;
 			} else if (cmd == "jit") {
 				jitEnabled = true;
+			} else if (cmd == "ast-arena") {
+#if DAS_AST_ARENA
+				astArenaEnabled = true;
+#else
+				printf("ast-arena requires DAS_AST_ARENA build\n");
+				print_help();
+				return -1;
+#endif
+			} else if (cmd == "aot-live") {
+				if (i + 1 >= argc) {
+					printf("aot-live requires cache directory\n");
+					print_help();
+					return -1;
+				}
+				liveAotDir = argv[i + 1];
+				i += 1;
 			} else if (cmd == "log") {
 				outputProgramCode = true;
 			} else if (cmd == "dry-run") {
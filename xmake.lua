@@ -12,6 +12,12 @@ set_default(false)
 set_showmenu(true)
 option_end()
 
+option("das_ast_arena")
+set_default(false)
+set_showmenu(true)
+set_description("Allocate AST nodes from the per-program arena, when CodeOfPolicies::ast_arena is set")
+option_end()
+
 rule_end()
 if (os.projectdir() == os.scriptdir()) then
     if is_mode("debug") then
@@ -50,6 +56,11 @@ add_cxflags("/bigobj", {
 add_deps('uriparser', 'eastl', 'das_fmt')
 add_files('src/**.cpp', 'xxHash/xxhash.c')
 set_pcxxheader('src/pch.h')
+if get_config('das_ast_arena') then
+    add_defines('DAS_AST_ARENA=1', {
+        public = true
+    })
+end
 target_end()
 
 target('daScript_modules')